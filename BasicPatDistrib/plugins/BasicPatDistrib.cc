@@ -9,13 +9,13 @@ Description: produces histograms of basic quantities from PAT collections
 
 Implementation:
    - lepton isolation might need to be refined
-   - muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/UPGTrackerTDRStudies#Muon_identification
-   - electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
-      /!\ no ID is implemented for forward electrons as:
-      - PFClusterProducer does not run on miniAOD
-      - jurassic isolation needs tracks
-   - PF jet ID comes from Run-2 https://github.com/cms-sw/cmssw/blob/CMSSW_9_1_1_patch1/PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h
+   - the PF jet ID is read from the ValueMap of packed working point bits of PatJetIDProducer (jetID),
+     see objectid::JetBits
+   - the primary vertex is read from the VertexContext of VertexContextProducer (vertexContext)
    - no JEC applied
+   - jets and gen jets overlapping with a lepton are removed with the keep-masks of OverlapRemovalProducer
+   - the gen lepton isolation sums the constituents of the selected gen jets, copied once per event into
+     flat arrays (GenJetConstituents)
    - b-tagging WP come from Run-2 https://twiki.cern.ch/twiki/bin/viewauth/CMS/BtagRecommendation80XReReco#Supported_Algorithms_and_Operati 
       - for pfCombinedInclusiveSecondaryVertexV2BJetTags: L = 0.5426, M = 0.8484, T = 0.9535)
       - for deepCSV: L = 0.2219, M = 0.6324, T = 0.8958
@@ -53,11 +53,9 @@ Implementation:
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
 
 #include "DataFormats/PatCandidates/interface/Muon.h"
-#include "DataFormats/MuonReco/interface/MuonSelectors.h"
 #include "DataFormats/PatCandidates/interface/Electron.h"
-#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
+#include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
-#include "PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h"
 #include "DataFormats/PatCandidates/interface/MET.h"
 #include "DataFormats/PatCandidates/interface/PackedGenParticle.h"
 #include "DataFormats/HepMCCandidate/interface/GenParticle.h"
@@ -86,7 +84,6 @@ Implementation:
 #include "TH2.h"
 #include "TProfile.h"
 #include "TLorentzVector.h"
-#include "Math/GenVector/VectorUtil.h"
 
 //for photons
 #include "DataFormats/Common/interface/View.h"
@@ -94,6 +91,10 @@ Implementation:
 #include "TMath.h"
 #include "TTree.h"
 
+#include "PhaseTwoAnalysis/Common/interface/GenJetConstituents.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
 
 //
 // class declaration
@@ -123,27 +124,22 @@ class BasicPatDistrib : public edm::one::EDAnalyzer<edm::one::SharedResources>
     virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
     virtual void endJob() override;
 
-    bool isLooseElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-    bool isMediumElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-    bool isTightElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-    bool isME0MuonSel(reco::Muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi);
-
     // ----------member data ---------------------------
     edm::Service<TFileService> fs_;
 
     bool useDeepCSV_;
     edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
+    edm::EDGetTokenT<VertexContext> vertexContextToken_;
     edm::EDGetTokenT<std::vector<pat::Electron>> elecsToken_;
-    edm::EDGetTokenT<reco::BeamSpot> bsToken_;
-    edm::EDGetTokenT<std::vector<reco::Conversion>> convToken_;
     edm::EDGetTokenT<std::vector<pat::Muon>> muonsToken_;
     edm::EDGetTokenT<std::vector<pat::Jet>> jetsToken_;
-    PFJetIDSelectionFunctor jetIDLoose_;
-    PFJetIDSelectionFunctor jetIDTight_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> jetKeepMaskToken_;
+    edm::EDGetTokenT<edm::ValueMap<int>> jetIDToken_;
     edm::EDGetTokenT<std::vector<pat::MET>> metsToken_;
     edm::EDGetTokenT<std::vector<pat::PackedGenParticle>> genPartsToken_;
     edm::EDGetTokenT<std::vector<reco::GenParticle>> allGenPartsToken_;
     edm::EDGetTokenT<std::vector<reco::GenJet>> genJetsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> genJetKeepMaskToken_;
     edm::EDGetTokenT<std::vector<pat::Photon>> photonsToken_;
 
     // MC truth in fiducial phase space
@@ -332,17 +328,17 @@ class BasicPatDistrib : public edm::one::EDAnalyzer<edm::one::SharedResources>
 BasicPatDistrib::BasicPatDistrib(const edm::ParameterSet& iConfig):
   useDeepCSV_(iConfig.getParameter<bool>("useDeepCSV")),
   verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
+  vertexContextToken_(consumes<VertexContext>(iConfig.getParameter<edm::InputTag>("vertexContext"))),
   elecsToken_(consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-  bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot"))),
-  convToken_(consumes<std::vector<reco::Conversion>>(iConfig.getParameter<edm::InputTag>("conversions"))),  
   muonsToken_(consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
   jetsToken_(consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets"))),
-  jetIDLoose_(PFJetIDSelectionFunctor::FIRSTDATA, PFJetIDSelectionFunctor::LOOSE), 
-  jetIDTight_(PFJetIDSelectionFunctor::FIRSTDATA, PFJetIDSelectionFunctor::TIGHT), 
+  jetKeepMaskToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("jetKeepMask"))),
+  jetIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("jetID"))),
   metsToken_(consumes<std::vector<pat::MET>>(iConfig.getParameter<edm::InputTag>("mets"))),
   genPartsToken_(consumes<std::vector<pat::PackedGenParticle>>(iConfig.getParameter<edm::InputTag>("genParts"))),
   allGenPartsToken_(consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("allGenParts"))),
   genJetsToken_(consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genJets"))),
+  genJetKeepMaskToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("genJetKeepMask"))),
   photonsToken_(consumes<std::vector<pat::Photon>>(iConfig.getParameter<edm::InputTag>("photons"))),
   minPhotonEt_(iConfig.getParameter<double>("minPhotonEt")),
   minPhotonAbsEta_(iConfig.getParameter<double>("minPhotonAbsEta")),
@@ -538,14 +534,11 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   //Gathering Physics Objects 
   Handle<std::vector<reco::Vertex>> vertices;
   iEvent.getByToken(verticesToken_, vertices);
+  Handle<VertexContext> vtxContext;
+  iEvent.getByToken(vertexContextToken_, vtxContext);
 
   Handle<std::vector<pat::Electron>> elecs;
   iEvent.getByToken(elecsToken_, elecs);
-  //  Handle<reco::ConversionCollection> conversions;
-  //  iEvent.getByToken(convToken_, conversions);
-  Handle<reco::BeamSpot> bsHandle;
-  iEvent.getByToken(bsToken_, bsHandle);
-  const reco::BeamSpot &beamspot = *bsHandle.product();  
 
   Handle<std::vector<pat::Muon>> muons;
   iEvent.getByToken(muonsToken_, muons);
@@ -555,6 +548,10 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
 
   Handle<std::vector<pat::Jet>> jets;
   iEvent.getByToken(jetsToken_, jets);
+  Handle<ValueMap<bool>> jetKeepMask;
+  iEvent.getByToken(jetKeepMaskToken_, jetKeepMask);
+  Handle<ValueMap<int>> jetID;
+  iEvent.getByToken(jetIDToken_, jetID);
 
   Handle<std::vector<pat::PackedGenParticle>> genParts;
   iEvent.getByToken(genPartsToken_, genParts);
@@ -565,6 +562,8 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
 
   Handle<std::vector<reco::GenJet>> genJets;
   iEvent.getByToken(genJetsToken_, genJets);
+  Handle<ValueMap<bool>> genJetKeepMask;
+  iEvent.getByToken(genJetKeepMaskToken_, genJetKeepMask);
 
   //Handle< View<pat::Photon> >  photonHandle;
   //iEvent.getByLabel("slimmedPhotons", photonHandle);
@@ -595,32 +594,16 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   nRecoPhotons= 0;
 
   // Vertices
-  int prVtx = -1;
-  size_t nVtx = 0;
-  for (size_t i = 0; i < vertices->size(); i++) {
-    if (vertices->at(i).isFake()) continue;
-    if (vertices->at(i).ndof() <= 4) continue;
-    if (prVtx < 0) prVtx = i;
-    ++ nVtx;
-  }
-  if (prVtx < 0) return;
-  h_goodVertices_n_->Fill(nVtx);
+  if (!vtxContext->hasPrimaryVertex()) return;
+  h_goodVertices_n_->Fill(vtxContext->nGoodVertices);
   h_allVertices_n_->Fill(vertices->size());
    
   // MC truth in fiducial phase space
-  std::vector<size_t> jGenJets;
+  GenJetConstituents genJetConstituents;
   size_t nGenJets = 0;
   for (size_t i = 0; i < genJets->size(); i++) {
-    bool overlaps = false;
-    for (size_t j = 0; j < genParts->size(); j++) {
-      if (abs(genParts->at(j).pdgId()) != 11 && abs(genParts->at(j).pdgId()) != 13) continue;
-      if (fabs(genJets->at(i).pt()-genParts->at(j).pt()) < 0.01*genParts->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(genParts->at(j).p4(),genJets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    jGenJets.push_back(i);
+    if (!genJetKeepMask->get(genJets.id(), i)) continue;
+    genJetConstituents.addJet(genJets->at(i));
 
     if (genJets->at(i).pt() < 30.) continue;
     if (fabs(genJets->at(i).eta()) > 4.7) continue;
@@ -720,18 +703,8 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   for (size_t i = 0; i < genParts->size(); i++) {
     if (abs(genParts->at(i).pdgId()) != 11 && abs(genParts->at(i).pdgId()) != 13) continue;
     if (fabs(genParts->at(i).eta()) > 2.8) continue;
-    double genIso = 0.;
-    for (size_t j = 0; j < jGenJets.size(); j++) {
-      if (ROOT::Math::VectorUtil::DeltaR(genParts->at(i).p4(),genJets->at(jGenJets[j]).p4()) > 0.7) continue; 
-      std::vector<const reco::Candidate *> jconst = genJets->at(jGenJets[j]).getJetConstituentsQuick();
-      for (size_t k = 0; k < jconst.size(); k++) {
-        double deltaR = ROOT::Math::VectorUtil::DeltaR(genParts->at(i).p4(),jconst[k]->p4());
-        if (deltaR < 0.01) continue;
-        if (abs(genParts->at(i).pdgId()) == 13 && deltaR > 0.4) continue;
-        if (abs(genParts->at(i).pdgId()) == 11 && deltaR > 0.3) continue;
-        genIso = genIso + jconst[k]->pt();
-      }
-    }
+    const float dRIso = (abs(genParts->at(i).pdgId()) == 13 ? 0.4 : 0.3);
+    double genIso = genJetConstituents.sumPt(genParts->at(i).eta(), genParts->at(i).phi(), 0.7, 0.01, dRIso);
     genIso = genIso / genParts->at(i).pt();
     if (genIso > 0.15) continue;
     if (abs(genParts->at(i).pdgId()) == 13) {
@@ -777,21 +750,7 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   size_t nGoodBtaggedJets = 0;
   size_t nbGoodBtaggedJets = 0;
   for (size_t i =0; i < jets->size(); i++) {
-    bool overlaps = false;
-    for (size_t j = 0; j < elecs->size(); j++) {
-      if (fabs(jets->at(i).pt()-elecs->at(j).pt()) < 0.01*elecs->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(elecs->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    for (size_t j = 0; j < muons->size(); j++) {
-      if (fabs(jets->at(i).pt()-muons->at(j).pt()) < 0.01*muons->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(muons->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
+    if (!jetKeepMask->get(jets.id(), i)) continue;
 
     double btagDisc = -1.;
     if (useDeepCSV_)
@@ -804,17 +763,14 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
     h_allJets_phi_->Fill(jets->at(i).phi());
     h_allJets_eta_->Fill(jets->at(i).eta());
     h_allJets_csv_->Fill(btagDisc); 
+    const int idBits = jetID->get(jets.id(), i);
     h_allJets_id_->Fill(0.);
-    pat::strbitset retLoose = jetIDLoose_.getBitTemplate();
-    retLoose.set(false);
-    if (jetIDLoose_(jets->at(i), retLoose)) h_allJets_id_->Fill(1.);
-    pat::strbitset retTight = jetIDTight_.getBitTemplate();
-    retTight.set(false);
-    if (jetIDTight_(jets->at(i), retTight)) h_allJets_id_->Fill(2.);
+    if (objectid::pass(idBits, objectid::JET_LOOSE)) h_allJets_id_->Fill(1.);
+    if (objectid::pass(idBits, objectid::JET_TIGHT)) h_allJets_id_->Fill(2.);
 
     if (jets->at(i).pt() < 30.) continue;
     if (fabs(jets->at(i).eta()) > 4.7) continue;
-    if (!jetIDLoose_(jets->at(i), retLoose)) continue;
+    if (!objectid::pass(idBits, objectid::JET_LOOSE)) continue;
     h_goodJets_pt_->Fill(jets->at(i).pt());
     h_goodJets_phi_->Fill(jets->at(i).phi());
     h_goodJets_eta_->Fill(jets->at(i).eta());
@@ -1142,109 +1098,6 @@ BasicPatDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
 }
 
 
-// ------------ method check that an e passes loose id ----------------------------------
-  bool BasicPatDistrib::isLooseElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-  if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-  if (patEl.full5x5_sigmaIetaIeta() > 0.02992) return false;
-  if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.004119) return false;
-  if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.05176) return false;
-  if (patEl.hcalOverEcal() > 6.741) return false;
-  if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 2.5) return false;
-  double Ooemoop = 999.;
-  if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-  else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-  if (Ooemoop > 73.76) return false;
-  if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-  return true;
-}
-
-// ------------ method check that an e passes medium ID ----------------------------------
-  bool
-BasicPatDistrib::isMediumElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-  if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-  if (patEl.full5x5_sigmaIetaIeta() > 0.01609) return false;
-  if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.001766) return false;
-  if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.03130) return false;
-  if (patEl.hcalOverEcal() > 7.371) return false;
-  if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 1.325) return false;
-  double Ooemoop = 999.;
-  if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-  else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-  if (Ooemoop > 22.6) return false;
-  if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-  return true;
-}
-
-// ------------ method check that an e passes tight ID ----------------------------------
-  bool
-BasicPatDistrib::isTightElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-  if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-  if (patEl.full5x5_sigmaIetaIeta() > 0.01614) return false;
-  if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.001322) return false;
-  if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.06129) return false;
-  if (patEl.hcalOverEcal() > 4.492) return false;
-  if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 1.255) return false;
-  double Ooemoop = 999.;
-  if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-  else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-  if (Ooemoop > 18.26) return false;
-  if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-  return true;
-}
-
-// ------------ method to improve ME0 muon ID ----------------
-  bool 
-BasicPatDistrib::isME0MuonSel(reco::Muon muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi)
-{
-
-  bool result = false;
-  bool isME0 = muon.isME0Muon();
-
-  if(isME0){
-
-    double deltaX = 999;
-    double deltaY = 999;
-    double pullX = 999;
-    double pullY = 999;
-    double deltaPhi = 999;
-
-    bool X_MatchFound = false, Y_MatchFound = false, Dir_MatchFound = false;
-
-    const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-    for(std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber){
-
-      for (std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment){
-
-        if (chamber->detector() == 5){
-
-          deltaX   = fabs(chamber->x - segment->x);
-          deltaY   = fabs(chamber->y - segment->y);
-          pullX    = fabs(chamber->x - segment->x) / std::sqrt(chamber->xErr + segment->xErr);
-          pullY    = fabs(chamber->y - segment->y) / std::sqrt(chamber->yErr + segment->yErr);
-          deltaPhi = fabs(atan(chamber->dXdZ) - atan(segment->dXdZ));
-
-        }
-      }
-    }
-
-    if ((pullX < pullXCut) || (deltaX < dXCut)) X_MatchFound = true;
-    if ((pullY < pullYCut) || (deltaY < dYCut)) Y_MatchFound = true;
-    if (deltaPhi < dPhi) Dir_MatchFound = true;
-
-    result = X_MatchFound && Y_MatchFound && Dir_MatchFound;
-
-  }
-
-  return result;
-
-}
-
 // ------------ method called once each job just before starting event loop  ------------
   void 
 BasicPatDistrib::beginJob()
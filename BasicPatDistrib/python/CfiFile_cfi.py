@@ -2,16 +2,17 @@ import FWCore.ParameterSet.Config as cms
 
 myana = cms.EDAnalyzer('BasicPatDistrib',
         vertices      = cms.InputTag("offlineSlimmedPrimaryVertices"),
+        vertexContext = cms.InputTag("patVertexContext"),
         electrons     = cms.InputTag("slimmedElectrons"),
-        beamspot      = cms.InputTag("offlineBeamSpot"),
-        #conversions   = cms.InputTag("reducedEgamma", "reducedConversions", "PAT"),
-        conversions   = cms.InputTag("reducedEgamma", "reducedConversions", "RECO"),
         muons         = cms.InputTag("slimmedMuons"),
         jets          = cms.InputTag("slimmedJetsPuppi"),
+        jetKeepMask   = cms.InputTag("patJetLeptonOverlaps"),
+        jetID         = cms.InputTag("patJetID"),
         useDeepCSV    = cms.bool(True),
         mets          = cms.InputTag("slimmedMETsPuppi"),
         genParts      = cms.InputTag("packedGenParticles"),
         genJets       = cms.InputTag("slimmedGenJets"),
+        genJetKeepMask = cms.InputTag("patGenJetLeptonOverlaps"),
         #Maxime added for Gen photons? 
         allGenParts   = cms.InputTag("prunedGenParticles"),
         #Added photons!
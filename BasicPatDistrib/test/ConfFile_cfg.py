@@ -83,6 +83,13 @@ if (PU == 0):
 process.myana = cms.EDAnalyzer('BasicPatDistrib')
 process.load("PhaseTwoAnalysis.BasicPatDistrib.CfiFile_cfi")
 process.myana.useDeepCSV = True
+# primary vertex and jet ID bits, evaluated once per event
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Jets.PatJetIDProducer_cfi")
+process.patJetID.jets = process.myana.jets
+process.patJetID.pileup = PU
+# jets and gen jets overlapping with a lepton, computed once per event
+process.load("PhaseTwoAnalysis.Common.OverlapRemovalProducer_cfi")
 
 
-process.p = cms.Path(process.myana)
+process.p = cms.Path(process.patVertexContext * process.patJetID * process.patJetLeptonOverlaps * process.patGenJetLeptonOverlaps * process.myana)
@@ -9,10 +9,13 @@ Description: produces histograms of basic quantities from RECO collections
 
 Implementation:
    - muon isolation comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_isolation 
-   - muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_identification
    - electron isolation needs to be refined
-   - electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
+   - isolation sums are read from the ValueMaps of MultiConeIsolationProducer
+   - muon and electron IDs are read from the ValueMaps of packed working point bits of MuonIDProducer
+     (muonID) and RecoElectronIDProducer (electronID), see objectid::MuonBits and objectid::ElectronBits
+   - the primary vertex is read from the VertexContext of VertexContextProducer (vertexContext)
    - no jet ID nor JEC are applied
+   - jets overlapping with a lepton are removed with the keep-mask of OverlapRemovalProducer (jetKeepMask)
    - b-tagging is not available 
 
 */
@@ -40,7 +43,6 @@ Implementation:
 #include "DataFormats/MuonReco/interface/Muon.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include "EgammaAnalysis/ElectronTools/interface/ElectronEffectiveArea.h"
-#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
 #include "DataFormats/JetReco/interface/PFJet.h"
@@ -50,24 +52,17 @@ Implementation:
 #include "DataFormats/Candidate/interface/Candidate.h"
 #include "DataFormats/JetReco/interface/GenJet.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
-#include "Geometry/Records/interface/MuonGeometryRecord.h"
-#include "Geometry/GEMGeometry/interface/ME0EtaPartitionSpecs.h"
-#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
 
-#include "FWCore/Framework/interface/ESHandle.h"
-
-#include "DataFormats/MuonReco/interface/MuonSelectors.h"
-#include "RecoEgamma/Phase2InterimID/interface/HGCalIDTool.h"
 #include "DataFormats/Common/interface/Ptr.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
 
 #include "TFile.h"
 #include "TH1.h"
 #include "TH2.h"
 #include "TTree.h"
 #include "TLorentzVector.h"
-#include "Math/GenVector/VectorUtil.h"
-#include "TMVA/Reader.h" 
-#include "TMVA/MethodBDT.h" 
 
 //
 // class declaration
@@ -86,11 +81,6 @@ class BasicRecoDistrib : public edm::one::EDAnalyzer<edm::one::SharedResources,
 
     static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
 
-    enum ElectronMatchType {UNMATCHED = 0,
-      TRUE_PROMPT_ELECTRON,
-      TRUE_ELECTRON_FROM_TAU,
-      TRUE_NON_PROMPT_ELECTRON};  
-
   private:
     virtual void beginJob() override;
     virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
@@ -98,39 +88,27 @@ class BasicRecoDistrib : public edm::one::EDAnalyzer<edm::one::SharedResources,
     virtual void endRun(edm::Run const&, edm::EventSetup const&) override;
     virtual void endJob() override;
 
-    bool isME0MuonSel(reco::Muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi);
-    bool isME0MuonSelNew(reco::Muon, double, double, double);    
-    bool isLooseElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    bool isMediumElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    bool isTightElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    int matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles);
-    void findFirstNonElectronMother(const reco::Candidate *particle, int &ancestorPID, int &ancestorStatus);
-    float evalMVAElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, double isoEl, int vertexSize);
-
     // ----------member data ---------------------------
     edm::Service<TFileService> fs_;
 
-    std::unique_ptr<HGCalIDTool> hgcEmId_; 
-    TMVA::Reader tmvaReader_;
-    float hgcId_startPosition, hgcId_lengthCompatibility, hgcId_sigmaietaieta, hgcId_deltaEtaStartPosition, hgcId_deltaPhiStartPosition, hOverE_hgcalSafe, hgcId_cosTrackShowerAngle, trackIsoR04jurassic_D_pt, ooEmooP, d0, dz, pt, etaSC, phiSC, nPV, expectedMissingInnerHits, passConversionVeto, isTrue;
-
     unsigned int pileup_;
     edm::EDGetTokenT<std::vector<reco::GsfElectron>> elecsToken_;
-    edm::EDGetTokenT<reco::BeamSpot> bsToken_;
-    edm::EDGetTokenT<std::vector<reco::Conversion>> convToken_;
-    edm::EDGetTokenT<edm::ValueMap<double>> trackIsoValueMapToken_;
+    edm::EDGetTokenT<edm::ValueMap<int>> elecIDToken_;
     edm::EDGetTokenT<std::vector<reco::Muon>> muonsToken_;
+    edm::EDGetTokenT<edm::ValueMap<int>> muonIDToken_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_charged_hadrons_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_neutral_hadrons_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_photons_;
-    edm::EDGetTokenT<std::vector<reco::PFCandidate>> pfCandsToken_;
-    edm::EDGetTokenT<std::vector<reco::PFCandidate>> pfCandsNoLepToken_;
+    edm::EDGetTokenT<std::vector<reco::PFCandidate>> pfElecsToken_;
+    edm::EDGetTokenT<std::vector<reco::PFCandidate>> pfMuonsToken_;
+    std::vector<edm::EDGetTokenT<edm::ValueMap<float>>> elecIsolationTokens_;
+    std::vector<edm::EDGetTokenT<edm::ValueMap<float>>> pfElecIsolationTokens_;
+    std::vector<edm::EDGetTokenT<edm::ValueMap<float>>> pfMuonIsolationTokens_;
     edm::EDGetTokenT<std::vector<reco::PFJet>> jetsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> jetKeepMaskToken_;
     edm::EDGetTokenT<std::vector<reco::PFMET>> metToken_;
-    edm::EDGetTokenT<std::vector<reco::GenParticle>> genPartsToken_;
     edm::EDGetTokenT<std::vector<reco::GenJet>> genJetsToken_;
-    edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
-    const ME0Geometry* ME0Geometry_; 
+    edm::EDGetTokenT<VertexContext> vertexContextToken_;
     double muThres_;
 
     // Electrons
@@ -234,22 +212,27 @@ class BasicRecoDistrib : public edm::one::EDAnalyzer<edm::one::SharedResources,
 BasicRecoDistrib::BasicRecoDistrib(const edm::ParameterSet& iConfig): 
   pileup_(iConfig.getParameter<unsigned int>("pileup")),
   elecsToken_(consumes<std::vector<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-  bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot"))),
-  convToken_(consumes<std::vector<reco::Conversion>>(iConfig.getParameter<edm::InputTag>("conversions"))),
-  trackIsoValueMapToken_(consumes<edm::ValueMap<double>>(iConfig.getParameter<edm::InputTag>("trackIsoValueMap"))),
+  elecIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("electronID"))),
   muonsToken_(consumes<std::vector<reco::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
-  pfCandsToken_(consumes<std::vector<reco::PFCandidate>>(iConfig.getParameter<edm::InputTag>("pfCands"))),
-  pfCandsNoLepToken_(consumes<std::vector<reco::PFCandidate>>(iConfig.getParameter<edm::InputTag>("pfCandsNoLep"))),
+  muonIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("muonID"))),
+  pfElecsToken_(consumes<std::vector<reco::PFCandidate>>(iConfig.getParameter<edm::InputTag>("pfElecs"))),
+  pfMuonsToken_(consumes<std::vector<reco::PFCandidate>>(iConfig.getParameter<edm::InputTag>("pfMuons"))),
   jetsToken_(consumes<std::vector<reco::PFJet>>(iConfig.getParameter<edm::InputTag>("jets"))),
+  jetKeepMaskToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("jetKeepMask"))),
   metToken_(consumes<std::vector<reco::PFMET>>(iConfig.getParameter<edm::InputTag>("met"))),
-  genPartsToken_(consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genParts"))),
   genJetsToken_(consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genJets"))),
-  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices")))
+  vertexContextToken_(consumes<VertexContext>(iConfig.getParameter<edm::InputTag>("vertexContext")))
 {
   //now do what ever initialization is needed
   PUPPINoLeptonsIsolation_charged_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationChargedHadrons"));
   PUPPINoLeptonsIsolation_neutral_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationNeutralHadrons"));
   PUPPINoLeptonsIsolation_photons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationPhotons"));
+  for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("elecIsolation"))
+    elecIsolationTokens_.push_back(consumes<edm::ValueMap<float>>(tag));
+  for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("pfElecIsolation"))
+    pfElecIsolationTokens_.push_back(consumes<edm::ValueMap<float>>(tag));
+  for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("pfMuonIsolation"))
+    pfMuonIsolationTokens_.push_back(consumes<edm::ValueMap<float>>(tag));
 
   if (pileup_ == 0) {
     muThres_ = 0.152;
@@ -262,32 +245,6 @@ BasicRecoDistrib::BasicRecoDistrib(const edm::ParameterSet& iConfig):
 
   usesResource("TFileService");
 
-  const edm::ParameterSet& hgcIdCfg = iConfig.getParameterSet("HGCalIDToolConfig");
-  auto cc = consumesCollector();
-  hgcEmId_.reset( new HGCalIDTool(hgcIdCfg, cc) );
-
-  tmvaReader_.SetOptions("!Color:Silent:!Error");
-  tmvaReader_.AddVariable("hgcId_startPosition", &hgcId_startPosition);
-  tmvaReader_.AddVariable("hgcId_lengthCompatibility", &hgcId_lengthCompatibility);
-  tmvaReader_.AddVariable("hgcId_sigmaietaieta", &hgcId_sigmaietaieta);
-  tmvaReader_.AddVariable("abs(hgcId_deltaEtaStartPosition)", &hgcId_deltaEtaStartPosition);
-  tmvaReader_.AddVariable("abs(hgcId_deltaPhiStartPosition)", &hgcId_deltaPhiStartPosition);
-  tmvaReader_.AddVariable("hOverE_hgcalSafe", &hOverE_hgcalSafe);
-  tmvaReader_.AddVariable("hgcId_cosTrackShowerAngle", &hgcId_cosTrackShowerAngle);
-  tmvaReader_.AddVariable("trackIsoR04jurassic_D_pt := trackIsoR04jurassic/pt", &trackIsoR04jurassic_D_pt);
-  tmvaReader_.AddVariable("abs(ooEmooP)", &ooEmooP);
-  tmvaReader_.AddVariable("abs(d0)", &d0);
-  tmvaReader_.AddVariable("abs(dz)", &dz);
-  tmvaReader_.AddVariable("expectedMissingInnerHits", &expectedMissingInnerHits);
-  tmvaReader_.AddSpectator("pt",  &pt);
-  tmvaReader_.AddSpectator("nPV",  &nPV);
-  tmvaReader_.AddSpectator("etaSC",  &etaSC);
-  tmvaReader_.AddSpectator("phiSC",  &phiSC);
-  tmvaReader_.AddSpectator("isTrue",  &isTrue);
-  tmvaReader_.AddSpectator("passConversionVeto", &passConversionVeto);
-
-  tmvaReader_.BookMVA("PhaseIIEndcapHGCal","TMVAClassification_BDT.weights.xml");
-
   // Electrons
   h_allElecs_n_ = fs_->make<TH1D>("AllElecsN",";Number of electrons;Events / 1",10,0.,10.);
   h_allElecs_pt_ = fs_->make<TH1D>("AllElecsPt",";p_{T}(e) (GeV);Events / (5 GeV)",50,0.,250.);
@@ -410,21 +367,15 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
 {
   using namespace edm;
 
-  hgcEmId_->getEventSetup(iSetup);
-  hgcEmId_->getEvent(iEvent);
-
   Handle<std::vector<reco::GsfElectron>> elecs;
   iEvent.getByToken(elecsToken_, elecs);
-  Handle<reco::ConversionCollection> conversions;
-  iEvent.getByToken(convToken_, conversions);
-  Handle<reco::BeamSpot> bsHandle;
-  iEvent.getByToken(bsToken_, bsHandle);
-  const reco::BeamSpot &beamspot = *bsHandle.product();
-  Handle<ValueMap<double>> trackIsoValueMap;
-  iEvent.getByToken(trackIsoValueMapToken_, trackIsoValueMap);
+  Handle<ValueMap<int>> elecID;
+  iEvent.getByToken(elecIDToken_, elecID);
 
   Handle<std::vector<reco::Muon>> muons;
   iEvent.getByToken(muonsToken_, muons);
+  Handle<ValueMap<int>> muonID;
+  iEvent.getByToken(muonIDToken_, muonID);
   edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_charged_hadrons;
   edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_neutral_hadrons;
   edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_photons;
@@ -432,35 +383,32 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
   iEvent.getByToken(PUPPINoLeptonsIsolation_neutral_hadrons_, PUPPINoLeptonsIsolation_neutral_hadrons);
   iEvent.getByToken(PUPPINoLeptonsIsolation_photons_, PUPPINoLeptonsIsolation_photons);  
 
-  Handle<std::vector<reco::PFCandidate>> pfCands;
-  iEvent.getByToken(pfCandsToken_, pfCands);
+  Handle<std::vector<reco::PFCandidate>> pfElecs;
+  iEvent.getByToken(pfElecsToken_, pfElecs);
+  Handle<std::vector<reco::PFCandidate>> pfMuons;
+  iEvent.getByToken(pfMuonsToken_, pfMuons);
 
-  Handle<std::vector<reco::PFCandidate>> pfCandsNoLep;
-  iEvent.getByToken(pfCandsNoLepToken_, pfCandsNoLep);
+  std::vector<Handle<ValueMap<float>>> elecIsolation(elecIsolationTokens_.size());
+  for (size_t k = 0; k < elecIsolationTokens_.size(); k++) iEvent.getByToken(elecIsolationTokens_[k], elecIsolation[k]);
+  std::vector<Handle<ValueMap<float>>> pfElecIsolation(pfElecIsolationTokens_.size());
+  for (size_t k = 0; k < pfElecIsolationTokens_.size(); k++) iEvent.getByToken(pfElecIsolationTokens_[k], pfElecIsolation[k]);
+  std::vector<Handle<ValueMap<float>>> pfMuonIsolation(pfMuonIsolationTokens_.size());
+  for (size_t k = 0; k < pfMuonIsolationTokens_.size(); k++) iEvent.getByToken(pfMuonIsolationTokens_[k], pfMuonIsolation[k]);
 
   Handle<std::vector<reco::PFJet>> jets;
   iEvent.getByToken(jetsToken_, jets);
+  Handle<ValueMap<bool>> jetKeepMask;
+  iEvent.getByToken(jetKeepMaskToken_, jetKeepMask);
 
   Handle<std::vector<reco::PFMET>> met;
   iEvent.getByToken(metToken_, met);
 
-  Handle<std::vector<reco::GenParticle>> genParts;
-  iEvent.getByToken(genPartsToken_, genParts);
-
   Handle<std::vector<reco::GenJet>> genJets;
   iEvent.getByToken(genJetsToken_, genJets);
 
-  Handle<std::vector<reco::Vertex>> vertices;
-  iEvent.getByToken(verticesToken_, vertices);
-
-
-  int prVtx = -1;
-  for(size_t i = 0; i < vertices->size(); i++) {
-    if (vertices->at(i).isFake()) continue;
-    if (vertices->at(i).ndof() <= 4.) continue;
-    if (prVtx < 0) prVtx = i;
-  }
-  if (prVtx < 0.) return;
+  Handle<VertexContext> vtxContext;
+  iEvent.getByToken(vertexContextToken_, vtxContext);
+  if (!vtxContext->hasPrimaryVertex()) return;
 
 
   // Electrons
@@ -471,26 +419,19 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
     h_allElecs_pt_->Fill(elecs->at(i).pt());
     h_allElecs_eta_->Fill(elecs->at(i).eta());
     h_allElecs_phi_->Fill(elecs->at(i).phi());
+    Ptr<const reco::GsfElectron> el4iso(elecs,i);
     double isoEl = 0.;
-    for (size_t k = 0; k < pfCandsNoLep->size(); k++) {
-      if (ROOT::Math::VectorUtil::DeltaR(elecs->at(i).p4(),pfCandsNoLep->at(k).p4()) > 0.4) continue;
-      isoEl += pfCandsNoLep->at(k).pt();
-    }
+    for (size_t k = 0; k < elecIsolation.size(); k++) isoEl += (*elecIsolation[k])[el4iso];
     if (elecs->at(i).pt() > 0.) isoEl = isoEl / elecs->at(i).pt(); 
     else isoEl = -1.;
     h_allElecs_iso_->Fill(isoEl);
-    Ptr<const reco::GsfElectron> el4iso(elecs,i);
-    double eljurassicIso = (*trackIsoValueMap)[el4iso];
-    double elpt = elecs->at(i).pt();
-    double elMVAVal = -1.;
-    if (hgcEmId_->setElectronPtr(&(elecs->at(i)))) 
-      elMVAVal = (double)evalMVAElec(elecs->at(i),vertices->at(prVtx),conversions,beamspot,genParts,eljurassicIso/elpt,vertices->size());
+    const int idBits = elecID->get(elecs.id(), i);
     h_allElecs_id_->Fill(0.);
-    if (isLooseElec(elecs->at(i),conversions,beamspot,elMVAVal)) h_allElecs_id_->Fill(1.);    
-    if (isMediumElec(elecs->at(i),conversions,beamspot,elMVAVal)) h_allElecs_id_->Fill(2.);    
-    if (isTightElec(elecs->at(i),conversions,beamspot,elMVAVal)) h_allElecs_id_->Fill(3.);    
+    if (objectid::pass(idBits, objectid::ELE_LOOSE)) h_allElecs_id_->Fill(1.);    
+    if (objectid::pass(idBits, objectid::ELE_MEDIUM)) h_allElecs_id_->Fill(2.);    
+    if (objectid::pass(idBits, objectid::ELE_TIGHT)) h_allElecs_id_->Fill(3.);    
 
-    if (!isTightElec(elecs->at(i),conversions,beamspot,elMVAVal)) continue;
+    if (!objectid::pass(idBits, objectid::ELE_TIGHT)) continue;
     if (fabs(elecs->at(i).eta()) > 2.8) continue;
     if (elecs->at(i).pt() < 20.) continue;
     h_elecs_pt_->Fill(elecs->at(i).pt());
@@ -512,27 +453,24 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
   //PF elecs
   int nPFElec =0;
   int nGoodPFElec = 0;
-  for (size_t i = 0; i < pfCands->size(); i++) {
-    if (abs(pfCands->at(i).pdgId()) != 11) continue;
+  for (size_t i = 0; i < pfElecs->size(); i++) {
+    Ptr<const reco::PFCandidate> pfref(pfElecs,i);
     double isoPFEl = 0.;
-    for (size_t k = 0; k < pfCandsNoLep->size(); k++) {
-      if (ROOT::Math::VectorUtil::DeltaR(pfCands->at(i).p4(),pfCandsNoLep->at(k).p4()) > 0.4) continue;
-      isoPFEl += pfCandsNoLep->at(k).pt();
-    }
-    isoPFEl = isoPFEl / pfCands->at(i).pt();
-    if (fabs(pfCands->at(i).eta()) > 2.8) continue;
-    if (pfCands->at(i).pt() < 20.) continue;
-    h_PFElecs_pt_->Fill(pfCands->at(i).pt());
-    h_PFElecs_eta_->Fill(pfCands->at(i).eta());
-    h_PFElecs_phi_->Fill(pfCands->at(i).phi());
+    for (size_t k = 0; k < pfElecIsolation.size(); k++) isoPFEl += (*pfElecIsolation[k])[pfref];
+    isoPFEl = isoPFEl / pfElecs->at(i).pt();
+    if (fabs(pfElecs->at(i).eta()) > 2.8) continue;
+    if (pfElecs->at(i).pt() < 20.) continue;
+    h_PFElecs_pt_->Fill(pfElecs->at(i).pt());
+    h_PFElecs_eta_->Fill(pfElecs->at(i).eta());
+    h_PFElecs_phi_->Fill(pfElecs->at(i).phi());
     h_PFElecs_iso_->Fill(isoPFEl);
     ++nPFElec;
 
-    if (pfCands->at(i).pt() < 30. || isoPFEl > 0.15 ||
-        (fabs(pfCands->at(i).eta()) > 1.479 && fabs(pfCands->at(i).eta()) < 1.5660)) continue;
-    h_goodPFElecs_pt_->Fill(pfCands->at(i).pt());
-    h_goodPFElecs_eta_->Fill(pfCands->at(i).eta());
-    h_goodPFElecs_phi_->Fill(pfCands->at(i).phi());
+    if (pfElecs->at(i).pt() < 30. || isoPFEl > 0.15 ||
+        (fabs(pfElecs->at(i).eta()) > 1.479 && fabs(pfElecs->at(i).eta()) < 1.5660)) continue;
+    h_goodPFElecs_pt_->Fill(pfElecs->at(i).pt());
+    h_goodPFElecs_eta_->Fill(pfElecs->at(i).eta());
+    h_goodPFElecs_phi_->Fill(pfElecs->at(i).phi());
     h_goodPFElecs_iso_->Fill(isoPFEl);
     ++nGoodPFElec;
   }
@@ -554,25 +492,12 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
     double isoMu = (muon_puppiIsoNoLep_ChargedHadron+muon_puppiIsoNoLep_NeutralHadron+muon_puppiIsoNoLep_Photon)/muons->at(i).pt();
     h_allMuons_iso_->Fill(isoMu);
     
-    // Loose ID
-    double dPhiCut = std::min(std::max(1.2/muons->at(i).p(),1.2/100),0.056);
-    double dPhiBendCut = std::min(std::max(0.2/muons->at(i).p(),0.2/100),0.0096);    
-    bool isLooseMuon = (fabs(muons->at(i).eta()) < 2.4 && muon::isLooseMuon(muons->at(i))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.077, dPhiCut, dPhiBendCut));
-
-    // Medium ID -- needs to be updated
-    bool ipxy = false, ipz = false, validPxlHit = false, highPurity = false;
-    if (muons->at(i).innerTrack().isNonnull()){
-    	ipxy = std::abs(muons->at(i).muonBestTrack()->dxy(vertices->at(prVtx).position())) < 0.2;
-    	ipz = std::abs(muons->at(i).muonBestTrack()->dz(vertices->at(prVtx).position())) < 0.5;
-    	validPxlHit = muons->at(i).innerTrack()->hitPattern().numberOfValidPixelHits() > 0;
-    	highPurity = muons->at(i).innerTrack()->quality(reco::Track::highPurity);
-    }    
-    bool isMediumMuon = (fabs(muons->at(i).eta()) < 2.4 && muon::isMediumMuon(muons->at(i))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.077, dPhiCut, dPhiBendCut) && ipxy && ipz && validPxlHit && highPurity);
-
-    // Tight ID
-    dPhiCut = std::min(std::max(1.2/muons->at(i).p(),1.2/100),0.032);
-    dPhiBendCut = std::min(std::max(0.2/muons->at(i).p(),0.2/100),0.0041);
-    bool isTightMuon = (fabs(muons->at(i).eta()) < 2.4 && vertices->size() > 0 && muon::isTightMuon(muons->at(i),vertices->at(prVtx))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.048, dPhiCut, dPhiBendCut) && ipxy && ipz && validPxlHit && highPurity);
+    // standard IDs within |eta| < 2.4, ME0 IDs beyond, the medium ME0 muons with the dz cut
+    const int idBits = muonID->get(muons.id(), i);
+    const bool inBarrel = fabs(muons->at(i).eta()) < 2.4;
+    bool isLooseMuon = (inBarrel && objectid::pass(idBits, objectid::MU_LOOSE)) || objectid::pass(idBits, objectid::MU_ME0_LOOSE);
+    bool isMediumMuon = (inBarrel && objectid::pass(idBits, objectid::MU_MEDIUM)) || objectid::pass(idBits, objectid::MU_ME0_MEDIUM | objectid::MU_ME0_IPZ);
+    bool isTightMuon = (inBarrel && objectid::pass(idBits, objectid::MU_TIGHT)) || objectid::pass(idBits, objectid::MU_ME0_TIGHT);
 
     h_allMuons_id_->Fill(0.);
     if (isLooseMuon) h_allMuons_id_->Fill(1.);
@@ -600,26 +525,23 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
   //PF muons
   int nPFMuon =0;
   int nGoodPFMuon = 0;
-  for (size_t i = 0; i < pfCands->size(); i++) {
-    if (abs(pfCands->at(i).pdgId()) != 13) continue;
+  for (size_t i = 0; i < pfMuons->size(); i++) {
+    Ptr<const reco::PFCandidate> pfref(pfMuons,i);
     double isoPFMu = 0.;
-    for (size_t k = 0; k < pfCandsNoLep->size(); k++) {
-      if (ROOT::Math::VectorUtil::DeltaR(pfCands->at(i).p4(),pfCandsNoLep->at(k).p4()) > 0.4) continue;
-      isoPFMu += pfCandsNoLep->at(k).pt();
-    }
-    isoPFMu = isoPFMu / pfCands->at(i).pt();
-    if (fabs(pfCands->at(i).eta()) > 2.8) continue;
-    if (pfCands->at(i).pt() < 10.) continue;
-    h_PFMuons_pt_->Fill(pfCands->at(i).pt());
-    h_PFMuons_eta_->Fill(pfCands->at(i).eta());
-    h_PFMuons_phi_->Fill(pfCands->at(i).phi());
+    for (size_t k = 0; k < pfMuonIsolation.size(); k++) isoPFMu += (*pfMuonIsolation[k])[pfref];
+    isoPFMu = isoPFMu / pfMuons->at(i).pt();
+    if (fabs(pfMuons->at(i).eta()) > 2.8) continue;
+    if (pfMuons->at(i).pt() < 10.) continue;
+    h_PFMuons_pt_->Fill(pfMuons->at(i).pt());
+    h_PFMuons_eta_->Fill(pfMuons->at(i).eta());
+    h_PFMuons_phi_->Fill(pfMuons->at(i).phi());
     h_PFMuons_iso_->Fill(isoPFMu);
     ++nPFMuon;
 
-    if (pfCands->at(i).pt() < 26. || isoPFMu > muThres_) continue;
-    h_goodPFMuons_pt_->Fill(pfCands->at(i).pt());
-    h_goodPFMuons_eta_->Fill(pfCands->at(i).eta());
-    h_goodPFMuons_phi_->Fill(pfCands->at(i).phi());
+    if (pfMuons->at(i).pt() < 26. || isoPFMu > muThres_) continue;
+    h_goodPFMuons_pt_->Fill(pfMuons->at(i).pt());
+    h_goodPFMuons_eta_->Fill(pfMuons->at(i).eta());
+    h_goodPFMuons_phi_->Fill(pfMuons->at(i).phi());
     h_goodPFMuons_iso_->Fill(isoPFMu);
     ++nGoodPFMuon;
   }
@@ -632,21 +554,7 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
   int nJet40 = 0;
   int nJet50 = 0;
   for(size_t i = 0; i < jets->size(); i++){
-    bool overlaps = false;
-    for (size_t j = 0; j < elecs->size(); j++) {
-      if (fabs(jets->at(i).pt()-elecs->at(j).pt()) < 0.01*elecs->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(elecs->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    for (size_t j = 0; j < muons->size(); j++) {
-      if (fabs(jets->at(i).pt()-muons->at(j).pt()) < 0.01*muons->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(muons->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
+    if (!jetKeepMask->get(jets.id(), i)) continue;
     if (fabs(jets->at(i).eta()) > 4.7) continue;
 
     if (jets->at(i).pt() < 20.) continue;
@@ -683,282 +591,6 @@ BasicRecoDistrib::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetu
 
 }
 
-// ------------ method to improve ME0 muon ID ----------------
-  bool 
-BasicRecoDistrib::isME0MuonSel(reco::Muon muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi)
-{
-
-  bool result = false;
-  bool isME0 = muon.isME0Muon();
-
-  if(isME0){
-
-    double deltaX = 999;
-    double deltaY = 999;
-    double pullX = 999;
-    double pullY = 999;
-    double deltaPhi = 999;
-
-    bool X_MatchFound = false, Y_MatchFound = false, Dir_MatchFound = false;
-
-    const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-    for(std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber){
-
-      for (std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment){
-
-        if (chamber->detector() == 5){
-
-          deltaX   = std::abs(chamber->x - segment->x);
-          deltaY   = std::abs(chamber->y - segment->y);
-          pullX    = std::abs(chamber->x - segment->x) / std::sqrt(chamber->xErr + segment->xErr);
-          pullY    = std::abs(chamber->y - segment->y) / std::sqrt(chamber->yErr + segment->yErr);
-          deltaPhi = std::abs(atan(chamber->dXdZ) - atan(segment->dXdZ));
-
-        }
-      }
-    }
-
-    if ((pullX < pullXCut) || (deltaX < dXCut)) X_MatchFound = true;
-    if ((pullY < pullYCut) || (deltaY < dYCut)) Y_MatchFound = true;
-    if (deltaPhi < dPhi) Dir_MatchFound = true;
-
-    result = X_MatchFound && Y_MatchFound && Dir_MatchFound;
-
-  }
-
-  return result;
-
-}
-
-bool 
-BasicRecoDistrib::isME0MuonSelNew(reco::Muon muon, double dEtaCut, double dPhiCut, double dPhiBendCut)
-{
-
-  bool result = false;
-  bool isME0 = muon.isME0Muon();
-
-  if(isME0){
-
-    double deltaEta = 999;
-    double deltaPhi = 999;
-    double deltaPhiBend = 999;
-
-    const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-    for( std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber ){
-
-      if (chamber->detector() == 5){
-
-        for ( std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment ){
-
-          LocalPoint trk_loc_coord(chamber->x, chamber->y, 0);
-          LocalPoint seg_loc_coord(segment->x, segment->y, 0);
-          LocalVector trk_loc_vec(chamber->dXdZ, chamber->dYdZ, 1);
-          LocalVector seg_loc_vec(segment->dXdZ, segment->dYdZ, 1);
-
-          const ME0Chamber * me0chamber = ME0Geometry_->chamber(chamber->id);
-
-          GlobalPoint trk_glb_coord = me0chamber->toGlobal(trk_loc_coord);
-          GlobalPoint seg_glb_coord = me0chamber->toGlobal(seg_loc_coord);
-
-          //double segDPhi = segment->me0SegmentRef->deltaPhi();
-          // need to check if this works
-          double segDPhi = me0chamber->computeDeltaPhi(seg_loc_coord, seg_loc_vec);
-          double trackDPhi = me0chamber->computeDeltaPhi(trk_loc_coord, trk_loc_vec);
-
-          deltaEta = std::abs(trk_glb_coord.eta() - seg_glb_coord.eta() );
-          deltaPhi = std::abs(trk_glb_coord.phi() - seg_glb_coord.phi() );
-          deltaPhiBend = std::abs(segDPhi - trackDPhi);
-
-          if (deltaEta < dEtaCut && deltaPhi < dPhiCut && deltaPhiBend < dPhiBendCut) result = true;
-
-        }
-      }
-    }
-
-  }
-
-  return result;
-
-}
-
-// ------------ loose elec ID -----------
-bool 
-BasicRecoDistrib::isLooseElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isLoose = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.02992
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.004119
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.05176
-      && recoEl.hcalOverEcal() < 6.741
-      && Ooemoop < 73.76
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 2.5
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isLoose = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isLoose : (MVAVal > -0.01)); 
-}
-
-// ------------ medium elec ID -----------
-bool 
-BasicRecoDistrib::isMediumElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isMedium = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.01609
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.001766
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.03130
-      && recoEl.hcalOverEcal() < 7.371
-      && Ooemoop < 22.6
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 1.325
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isMedium = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isMedium : (MVAVal > 0.03));  
-}
-
-// ------------ tight elec ID -----------
-bool 
-BasicRecoDistrib::isTightElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isTight = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.01614
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.001322
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.06129
-      && recoEl.hcalOverEcal() < 4.492
-      && Ooemoop < 18.26
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 1.255
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isTight = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isTight : (MVAVal > 0.1)); 
-}
-
-// ------------ match reco elec to gen elec ------------
-int 
-BasicRecoDistrib::matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles) {
-  // 
-  // Explicit loop and geometric matching method (advised by Josh Bendavid)
-  //
-
-  // Find the closest status 1 gen electron to the reco electron
-  double dR = 999;
-  const reco::Candidate *closestElectron = 0;
-  for(size_t i=0; i<genParticles->size();i++){
-    const reco::Candidate *particle = &(*genParticles)[i];
-    // Drop everything that is not electron or not status 1
-    if(abs(particle->pdgId()) != 11 || particle->status() != 1)
-      continue;
-    //
-    double dRtmp = ROOT::Math::VectorUtil::DeltaR( recoEl.p4(), particle->p4() );
-    if(dRtmp < dR){
-      dR = dRtmp;
-      closestElectron = particle;
-    }
-  }
-  // See if the closest electron (if it exists) is close enough.
-  // If not, no match found.
-  if(!(closestElectron != 0 && dR < 0.1)) {
-    return UNMATCHED;
-  }
-
-  // 
-  int ancestorPID = -999; 
-  int ancestorStatus = -999;
-  findFirstNonElectronMother(closestElectron, ancestorPID, ancestorStatus);
-
-  if(ancestorPID == -999 && ancestorStatus == -999){
-    // No non-electron parent??? This should never happen.
-    // Complain.
-    printf("SimpleElectronNtupler: ERROR! Electron does not apper to have a non-electron parent\n");
-    return UNMATCHED;
-  }
-
-  if(abs(ancestorPID) > 50 && ancestorStatus == 2)
-    return TRUE_NON_PROMPT_ELECTRON;
-
-  if(abs(ancestorPID) == 15 && ancestorStatus == 2)
-    return TRUE_ELECTRON_FROM_TAU;
-
-  // What remains is true prompt electrons
-  return TRUE_PROMPT_ELECTRON;
-}
-void 
-BasicRecoDistrib::findFirstNonElectronMother(const reco::Candidate *particle,
-    int &ancestorPID, int &ancestorStatus) {
-
-  if(particle == 0){
-    printf("SimpleElectronNtupler: ERROR! null candidate pointer, this should never happen\n");
-    return;
-  }
-
-  // Is this the first non-electron parent? If yes, return, otherwise
-  // go deeper into recursion
-  if(abs(particle->pdgId()) == 11){
-    findFirstNonElectronMother(particle->mother(0), ancestorPID, ancestorStatus);
-  }else{
-    ancestorPID = particle->pdgId();
-    ancestorStatus = particle->status();
-  }
-
-  return;
-}
-
-// ------------ tight HGCal electron ID --------------
-float 
-BasicRecoDistrib::evalMVAElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, double isoEl, int vertexSize) {
-
-  if (fabs(recoEl.superCluster()->eta()) < 1.556) return -1.;
-
-  bool isHGCal = hgcEmId_->setElectronPtr(&recoEl);
-  if (isHGCal)  {
-    hgcId_startPosition = std::abs(hgcEmId_->getClusterStartPosition().z());
-    hgcId_lengthCompatibility = hgcEmId_->getClusterLengthCompatibility();
-    hgcId_sigmaietaieta = hgcEmId_->getClusterSigmaEtaEta();
-    hgcId_deltaEtaStartPosition = recoEl.trackPositionAtCalo().eta() - hgcEmId_->getClusterStartPosition().eta();
-    hgcId_deltaPhiStartPosition = reco::deltaPhi(recoEl.trackPositionAtCalo().phi(), hgcEmId_->getClusterStartPosition().phi());
-    hOverE_hgcalSafe = hgcEmId_->getClusterHadronFraction();
-    hgcId_cosTrackShowerAngle = recoEl.trackMomentumOut().Unit().Dot(hgcEmId_->getClusterShowerAxis().Unit());
-  } else {
-    hgcId_startPosition = -1.;
-    hgcId_lengthCompatibility = -1.;
-    hgcId_sigmaietaieta = recoEl.full5x5_sigmaIetaIeta();
-    hgcId_deltaEtaStartPosition = -1.;
-    hgcId_deltaPhiStartPosition = -1.;
-    hOverE_hgcalSafe = recoEl.hcalOverEcal();
-    hgcId_cosTrackShowerAngle = -1.;
-  }
-  trackIsoR04jurassic_D_pt = (float)isoEl;
-  ooEmooP = 1e30;
-  if (recoEl.ecalEnergy() == 0) ooEmooP = 1e30;
-  else if (!std::isfinite(recoEl.ecalEnergy())) ooEmooP = 1e30;
-  else ooEmooP = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  d0 = recoEl.gsfTrack()->dxy(recoVtx.position());
-  dz = recoEl.gsfTrack()->dz(recoVtx.position());
-  pt = recoEl.pt();
-  etaSC = recoEl.superCluster()->eta();
-  phiSC = recoEl.superCluster()->phi();
-
-  expectedMissingInnerHits = (float)recoEl.gsfTrack()->hitPattern().numberOfHits(reco::HitPattern::MISSING_INNER_HITS);
-  isTrue = (float)matchToTruth(recoEl, genParticles);
-  nPV = (float)vertexSize;
-  if (!ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) passConversionVeto = 1.;
-  else passConversionVeto = 0.;
-
-  return (isHGCal ? tmvaReader_.EvaluateMVA("PhaseIIEndcapHGCal") : -1.);
-}
-
-
 // ------------ method called once each job just before starting event loop  ------------
   void 
 BasicRecoDistrib::beginJob()
@@ -969,9 +601,6 @@ BasicRecoDistrib::beginJob()
   void
 BasicRecoDistrib::beginRun(edm::Run const& iRun, edm::EventSetup const& iSetup)
 {
-  edm::ESHandle<ME0Geometry> hGeom;
-  iSetup.get<MuonGeometryRecord>().get(hGeom);
-  ME0Geometry_ =( &*hGeom);
 }
 
 // ------------ method called when ending the processing of a run  ------------
@@ -3,28 +3,28 @@ import FWCore.ParameterSet.Config as cms
 myana = cms.EDAnalyzer('BasicRecoDistrib',
         pileup       = cms.uint32(200),
         electrons    = cms.InputTag("ecalDrivenGsfElectrons"),
-        beamspot     = cms.InputTag("offlineBeamSpot"),
-        conversions  = cms.InputTag("particleFlowEGamma"),
-        trackIsoValueMap = cms.InputTag("electronTrackIsolationLcone"),
+        electronID   = cms.InputTag("electronID"),
         muons        = cms.InputTag("muons"),
+        muonID       = cms.InputTag("muonID"),
         puppiNoLepIsolationChargedHadrons = cms.InputTag("muonIsolationPUPPINoLep","h+-DR040-ThresholdVeto000-ConeVeto000"),
         puppiNoLepIsolationNeutralHadrons = cms.InputTag("muonIsolationPUPPINoLep","h0-DR040-ThresholdVeto000-ConeVeto001"),
         puppiNoLepIsolationPhotons        = cms.InputTag("muonIsolationPUPPINoLep","gamma-DR040-ThresholdVeto000-ConeVeto001"),    
-        pfCands      = cms.InputTag("particleFlow"),
-        pfCandsNoLep = cms.InputTag("particleFlow"),
+        elecIsolation = cms.VInputTag(cms.InputTag("leptonIsolation","electrons-h+-DR040"),
+                                      cms.InputTag("leptonIsolation","electrons-h0-DR040"),
+                                      cms.InputTag("leptonIsolation","electrons-gamma-DR040")),
+        pfElecs      = cms.InputTag("pfElecs"),
+        pfElecIsolation = cms.VInputTag(cms.InputTag("leptonIsolation","pfElecs-h+-DR040"),
+                                        cms.InputTag("leptonIsolation","pfElecs-h0-DR040"),
+                                        cms.InputTag("leptonIsolation","pfElecs-gamma-DR040")),
+        pfMuons      = cms.InputTag("pfMuons"),
+        pfMuonIsolation = cms.VInputTag(cms.InputTag("leptonIsolation","pfMuons-h+-DR040"),
+                                        cms.InputTag("leptonIsolation","pfMuons-h0-DR040"),
+                                        cms.InputTag("leptonIsolation","pfMuons-gamma-DR040")),
         jets         = cms.InputTag("ak4PFJetsCHS"),
+        jetKeepMask  = cms.InputTag("jetLeptonOverlaps"),
         met          = cms.InputTag("pfMet"),
-        genParts     = cms.InputTag("genParticles"),
         genJets      = cms.InputTag("ak4GenJets"),
-        vertices     = cms.InputTag("offlinePrimaryVertices"),
-        HGCalIDToolConfig = cms.PSet(
-            HGCBHInput = cms.InputTag("HGCalRecHit","HGCHEBRecHits"),
-            HGCEEInput = cms.InputTag("HGCalRecHit","HGCEERecHits"),
-            HGCFHInput = cms.InputTag("HGCalRecHit","HGCHEFRecHits"),
-            HGCPFRecHits = cms.InputTag("particleFlowRecHitHGC::MyAna"),
-            withPileup = cms.bool(True),
-            debug = cms.bool(False),
-        ),
+        vertexContext = cms.InputTag("vertexContext"),
         
 
 )
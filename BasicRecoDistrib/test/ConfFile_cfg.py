@@ -62,6 +62,21 @@ process.particleFlowNoLep = cms.EDFilter("PdgIdCandViewSelector",
                                     pdgId = cms.vint32( 1,2,22,111,130,310,2112,211,-211,321,-321,999211,2212,-2212 )
                                     )
 process.puppiNoLep = process.puppi.clone(candName = cms.InputTag('particleFlowNoLep'))
+
+# lepton isolation sums, computed in a single pass over the no-lepton PUPPI candidates
+process.load("PhaseTwoAnalysis.Common.MultiConeIsolationProducer_cfi")
+process.leptonIsolation.pfCands = cms.InputTag("puppiNoLep")
+process.pfElecs = cms.EDFilter("PdgIdPFCandidateSelector",
+                                src = cms.InputTag("puppi"),
+                                pdgId = cms.vint32(11,-11)
+                                )
+process.pfMuons = cms.EDFilter("PdgIdPFCandidateSelector",
+                                src = cms.InputTag("puppi"),
+                                pdgId = cms.vint32(13,-13)
+                                )
+process.leptonIsolation.srcToIsolate.append(cms.PSet(label = cms.string("pfElecs"), src = cms.InputTag("pfElecs")))
+process.leptonIsolation.srcToIsolate.append(cms.PSet(label = cms.string("pfMuons"), src = cms.InputTag("pfMuons")))
+
 process.load("TrackingTools.TransientTrack.TransientTrackBuilder_cfi")
 process.load("PhysicsTools.PatAlgos.slimming.primaryVertexAssociation_cfi")
 process.load("PhysicsTools.PatAlgos.slimming.offlineSlimmedPrimaryVertices_cfi")
@@ -90,8 +105,16 @@ process.electronTrackIsolationLcone.intRadiusEndcap = 0.04
 process.myana = cms.EDAnalyzer('BasicRecoDistrib'
 )
 process.load("PhaseTwoAnalysis.BasicRecoDistrib.CfiFile_cfi")
-process.myana.pfCands = "puppi"
-process.myana.pfCandsNoLep = "puppiNoLep"
+# conversion veto of the electrons, computed once per event
+process.load("PhaseTwoAnalysis.Electrons.ConversionVetoProducer_cfi")
+# primary vertex and muon and electron IDs, computed once per event
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Muons.MuonIDProducer_cfi")
+process.load("PhaseTwoAnalysis.Electrons.ElectronIDProducer_cfi")
+process.electronID.HGCalIDToolConfig.HGCPFRecHits = "particleFlowRecHitHGC::MyAna"
+# the ID histograms of all the electrons need the ID of every electron, not only of those in acceptance
+process.electronID.ptMin = 0.
+process.electronID.etaMax = 999.
 process.myana.met = "puppiMet"
 if options.updateJEC:
     # This will load several ESProducers and EDProducers which make the corrected jet collections
@@ -101,17 +124,20 @@ if options.updateJEC:
 else:
     # This simply switches the default AK4PFJetsCHS collection to the ak4PUPPIJets collection now that it has been produced
     process.myana.jets = "ak4PUPPIJets"
+# jets overlapping with a lepton, computed once per event
+process.load("PhaseTwoAnalysis.Common.OverlapRemovalProducer_cfi")
+process.jetLeptonOverlaps.jets = process.myana.jets
 
 
 process.TFileService = cms.Service("TFileService",
         fileName = cms.string('histos.root')
 )
 
-process.puSequence = cms.Sequence(process.primaryVertexAssociation * process.pfNoLepPUPPI * process.puppi * process.particleFlowNoLep * process.puppiNoLep * process.offlineSlimmedPrimaryVertices * process.packedPFCandidates * process.muonIsolationPUPPI * process.muonIsolationPUPPINoLep * process.ak4PUPPIJets * process.puppiMet)
+process.puSequence = cms.Sequence(process.primaryVertexAssociation * process.pfNoLepPUPPI * process.puppi * process.particleFlowNoLep * process.puppiNoLep * process.pfElecs * process.pfMuons * process.leptonIsolation * process.offlineSlimmedPrimaryVertices * process.packedPFCandidates * process.muonIsolationPUPPI * process.muonIsolationPUPPINoLep * process.ak4PUPPIJets * process.puppiMet)
 
 if options.updateJEC:
-    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.myana) 
+    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.conversionVeto * process.vertexContext * process.muonID * process.electronID * process.jetLeptonOverlaps * process.myana) 
 else:
-    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.myana) 
+    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.conversionVeto * process.vertexContext * process.muonID * process.electronID * process.jetLeptonOverlaps * process.myana) 
 
 
@@ -0,0 +1,94 @@
+#ifndef _deltarmatcher_h_
+#define _deltarmatcher_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Class:       DeltaRMatcher
+// Description: one-to-one deltaR matching of a reco collection to a gen collection
+//
+// The eta and phi of the two collections are copied once (the gen objects
+// being first filtered, e.g. on their pdg id), all the reco-gen pairs with
+// deltaR <= dRmax are computed in a single pass (one EtaPhiKernels call per
+// reco object), and the pairs are then assigned greedily by increasing
+// deltaR: each reco object gets the closest gen object not already taken by
+// a closer pair, so that two reco objects never share a gen object. Ties are
+// broken by the reco then gen index, the result does not depend on the
+// ordering of the computations.
+//
+// One object can be reused for all the collections of an event, keeping its
+// storage.
+
+#include <cstddef>
+#include <vector>
+
+class DeltaRMatcher
+{
+  public:
+    explicit DeltaRMatcher(float dRmax = 0.4) : dRmax_(dRmax) {}
+
+    // out[i] = index in the gen collection of the object matched to reco object i, -1 if none;
+    // only the gen objects ig with genSel(ig) are considered
+    template<typename C, typename Out, typename Sel>
+      void match(const C & recoEta, const C & recoPhi, size_t nReco,
+                 const C & genEta, const C & genPhi, size_t nGen, Sel genSel, Out & out);
+    template<typename C, typename Out>
+      void match(const C & recoEta, const C & recoPhi, size_t nReco,
+                 const C & genEta, const C & genPhi, size_t nGen, Out & out)
+      {
+        match(recoEta, recoPhi, nReco, genEta, genPhi, nGen, [](size_t) { return true; }, out);
+      }
+
+  private:
+    struct Pair {
+      float dR2;
+      unsigned reco, gen;
+      bool operator<(const Pair & other) const
+      {
+        if (dR2 != other.dR2) return dR2 < other.dR2;
+        if (reco != other.reco) return reco < other.reco;
+        return gen < other.gen;
+      }
+    };
+
+    // fills result_ from the cached coordinates
+    void assign();
+
+    float dRmax_;
+    std::vector<float> recoEta_, recoPhi_, genEta_, genPhi_;
+    std::vector<unsigned> genKey_;
+    std::vector<float> dR2Row_;
+    std::vector<Pair> pairs_;
+    std::vector<int> result_;
+    std::vector<bool> genTaken_;
+};
+
+//
+// template member functions
+//
+
+template<typename C, typename Out, typename Sel>
+  void
+DeltaRMatcher::match(const C & recoEta, const C & recoPhi, size_t nReco,
+                     const C & genEta, const C & genPhi, size_t nGen, Sel genSel, Out & out)
+{
+  recoEta_.resize(nReco);
+  recoPhi_.resize(nReco);
+  for (size_t i = 0; i < nReco; i++) {
+    recoEta_[i] = recoEta[i];
+    recoPhi_[i] = recoPhi[i];
+  }
+  genEta_.clear();
+  genPhi_.clear();
+  genKey_.clear();
+  for (size_t ig = 0; ig < nGen; ig++) {
+    if (!genSel(ig)) continue;
+    genEta_.push_back(genEta[ig]);
+    genPhi_.push_back(genPhi[ig]);
+    genKey_.push_back(ig);
+  }
+
+  assign();
+  for (size_t i = 0; i < nReco; i++) out[i] = result_[i];
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _etaphikernels_h_
+#define _etaphikernels_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Namespace:   etaphi
+// Description: deltaR kernels over flat (SoA) eta and phi arrays
+//
+// The kernels take one point (eta0, phi0) and n entries stored as plain float
+// arrays, and are written with SSE2 intrinsics, four entries at a time, when
+// the compiler targets it (always the case on x86-64); the remaining entries
+// and the other architectures use the scalar version. Both versions compute
+// the same float deltaR^2: dPhi is brought back into ]-pi, pi] by a single
+// +/- 2pi, the phis being expected in [-pi, pi]. The cone sums add the float
+// pTs in double, which is exact (so independent of the order of the additions
+// and of the vector width) unless the pTs span more than about 2^25. The arrays need no special
+// alignment (unaligned loads), but KinematicsSoA provides aligned storage.
+
+#include <cstddef>
+
+namespace etaphi {
+
+  // out[i] = deltaR^2 between (eta[i], phi[i]) and (eta0, phi0), i < n
+  void deltaR2(const float * eta, const float * phi, size_t n, float eta0, float phi0, float * out);
+
+  // scalar pT sum of the entries with dRmin <= deltaR <= dRmax of (eta0, phi0)
+  double sumPtInCone(const float * eta, const float * phi, const float * pt, size_t n,
+                     float eta0, float phi0, float dRmax, float dRmin = 0.f);
+
+  // index of the closest entry with deltaR <= dRmax, the lowest index in case
+  // of a tie, -1 if none; its deltaR^2 is written to dR2 if not null
+  int nearest(const float * eta, const float * phi, size_t n,
+              float eta0, float phi0, float dRmax, float * dR2 = nullptr);
+
+}
+
+#endif
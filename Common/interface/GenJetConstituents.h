@@ -0,0 +1,64 @@
+#ifndef _genjetconstituents_h_
+#define _genjetconstituents_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Class:       GenJetConstituents
+// Description: flat copy of the constituents of the selected gen jets, for the gen lepton isolation
+//
+// The eta, phi and pT of the constituents of each added jet are copied once
+// per event into contiguous arrays (one per variable), the constituents of
+// a jet being stored next to each other. The isolation of a gen lepton is then a loop over the jets close to
+// it and over their constituent ranges (EtaPhiKernels), instead of building
+// the constituent list and the p4s of each jet for each lepton.
+
+#include <cstddef>
+#include <vector>
+
+class GenJetConstituents
+{
+  public:
+    GenJetConstituents() : jetBegin_(1, 0) {}
+
+    void clear();
+    // append the constituents (daughters) of jet, which gets the next jet index
+    template<typename J>
+      void addJet(const J & jet);
+
+    size_t nJets() const { return jetEta_.size(); }
+    size_t size() const { return eta_.size(); }
+    float eta(size_t i) const { return eta_[i]; }
+    float phi(size_t i) const { return phi_[i]; }
+    float pt(size_t i) const { return pt_[i]; }
+
+    // scalar pT sum of the constituents with dRmin <= deltaR <= dRmax of (eta, phi),
+    // only the jets with deltaR <= dRjet being considered
+    double sumPt(float eta, float phi, float dRjet, float dRmin, float dRmax) const;
+
+  private:
+    std::vector<float> jetEta_, jetPhi_;
+    std::vector<unsigned> jetBegin_; // constituents of jet j: [jetBegin_[j], jetBegin_[j+1])
+    std::vector<float> eta_, phi_, pt_;
+};
+
+//
+// template member functions
+//
+
+template<typename J>
+  void
+GenJetConstituents::addJet(const J & jet)
+{
+  jetEta_.push_back(jet.eta());
+  jetPhi_.push_back(jet.phi());
+  const size_t n = jet.numberOfDaughters();
+  for (size_t k = 0; k < n; k++) {
+    const auto * constituent = jet.daughter(k);
+    eta_.push_back(constituent->eta());
+    phi_.push_back(constituent->phi());
+    pt_.push_back(constituent->pt());
+  }
+  jetBegin_.push_back(eta_.size());
+}
+
+#endif
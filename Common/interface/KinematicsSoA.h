@@ -0,0 +1,103 @@
+#ifndef _kinematicssoa_h_
+#define _kinematicssoa_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Class:       KinematicsSoA
+// Description: eta, phi and pT of a candidate collection cached in aligned flat arrays
+//
+// The collection is read once per event (eta and phi being computed once per
+// candidate instead of from its p4 at each deltaR), optionally keeping only
+// the selected candidates, and the deltaR queries then run the EtaPhiKernels
+// over the cached arrays. Each entry keeps the index of its candidate in the
+// source collection (its key), which is what the queries return.
+//
+// One object can be reused for all the events, keeping its storage.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "PhaseTwoAnalysis/Common/interface/EtaPhiKernels.h"
+
+// minimal allocator returning storage aligned on Align bytes
+template<typename T, size_t Align>
+  struct AlignedAllocator
+{
+  typedef T value_type;
+  template<typename U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+  AlignedAllocator() {}
+  template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) {}
+
+  T * allocate(size_t n)
+  {
+    void * p = nullptr;
+    if (posix_memalign(&p, Align, n*sizeof(T)) != 0) throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+  void deallocate(T * p, size_t) { free(p); }
+
+  template<typename U>
+    bool operator==(const AlignedAllocator<U, Align> &) const { return true; }
+  template<typename U>
+    bool operator!=(const AlignedAllocator<U, Align> &) const { return false; }
+};
+
+class KinematicsSoA
+{
+  public:
+    typedef std::vector<float, AlignedAllocator<float, 32>> FloatVector;
+
+    void clear();
+    void push_back(float eta, float phi, float pt, unsigned key);
+    // cache the candidates cands[i] (with sel(cands[i]) if given), key = i
+    template<typename C>
+      void fill(const C & cands);
+    template<typename C, typename Sel>
+      void fill(const C & cands, Sel sel);
+
+    size_t size() const { return eta_.size(); }
+    float eta(size_t i) const { return eta_[i]; }
+    float phi(size_t i) const { return phi_[i]; }
+    float pt(size_t i) const { return pt_[i]; }
+    unsigned key(size_t i) const { return key_[i]; }
+
+    // out[i] = deltaR^2 of entry i with (eta, phi)
+    void deltaR2(float eta, float phi, FloatVector & out) const;
+    // scalar pT sum of the entries with dRmin <= deltaR <= dRmax
+    double sumPtInCone(float eta, float phi, float dRmax, float dRmin = 0.f) const;
+    // key of the closest entry within dRmax (the lowest key in case of a tie), -1 if none
+    int nearest(float eta, float phi, float dRmax) const;
+
+  private:
+    FloatVector eta_, phi_, pt_;
+    std::vector<unsigned> key_;
+};
+
+//
+// template member functions
+//
+
+template<typename C>
+  void
+KinematicsSoA::fill(const C & cands)
+{
+  fill(cands, [](const typename C::value_type &) { return true; });
+}
+
+template<typename C, typename Sel>
+  void
+KinematicsSoA::fill(const C & cands, Sel sel)
+{
+  clear();
+  for (size_t i = 0; i < cands.size(); i++) {
+    const auto & cand = cands[i];
+    if (!sel(cand)) continue;
+    push_back(cand.eta(), cand.phi(), cand.pt(), i);
+  }
+}
+
+#endif
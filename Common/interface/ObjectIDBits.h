@@ -0,0 +1,51 @@
+#ifndef _objectidbits_h_
+#define _objectidbits_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Namespace:   objectid
+// Description: bit layout of the object IDs published by the ID producers
+//
+// MuonIDProducer, RecoElectronIDProducer, PatElectronIDProducer and
+// PatJetIDProducer evaluate every working point once per event and store
+// the result of each object as an edm::ValueMap<int> of the bits below;
+// the filters, ntuplers and analyzers only test the bits. The ME0 muon
+// bits are only set for |eta| > 2.4, the tight muon bit needs a primary
+// vertex (see VertexContext). MU_ME0_IPZ is the |dz| < 0.5 cut alone,
+// which some modules add to the medium ME0 working point.
+
+namespace objectid {
+
+  enum ElectronBits {
+    ELE_LOOSE           = 1 << 0,
+    ELE_MEDIUM          = 1 << 1,
+    ELE_TIGHT           = 1 << 2,
+  };
+
+  enum MuonBits {
+    MU_LOOSE            = 1 << 0,
+    MU_MEDIUM           = 1 << 1,
+    MU_TIGHT            = 1 << 2,
+    MU_ME0_LOOSE        = 1 << 3,
+    MU_ME0_MEDIUM       = 1 << 4,
+    MU_ME0_TIGHT        = 1 << 5,
+    MU_ME0_IPZ          = 1 << 6,
+  };
+
+  enum JetBits {
+    JET_LOOSE           = 1 << 0,
+    JET_TIGHT           = 1 << 1,
+    JET_MVAV2_LOOSE     = 1 << 2,
+    JET_MVAV2_MEDIUM    = 1 << 3,
+    JET_MVAV2_TIGHT     = 1 << 4,
+    JET_DEEPCSV_LOOSE   = 1 << 5,
+    JET_DEEPCSV_MEDIUM  = 1 << 6,
+    JET_DEEPCSV_TIGHT   = 1 << 7,
+  };
+
+  // true if all the bits of mask are set
+  inline bool pass(int bits, int mask) { return (bits & mask) == mask; }
+
+}
+
+#endif
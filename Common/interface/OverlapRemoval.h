@@ -0,0 +1,89 @@
+#ifndef _overlapremoval_h_
+#define _overlapremoval_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Class:       OverlapRemoval
+// Description: removal of the jets which are a copy of a lepton
+//
+// A jet overlaps with a lepton when their pTs agree within relPtMax (relative
+// to the lepton pT) and deltaR < dRmax, as in the former per-module loops.
+// The leptons are preselected once (e.g. on their pdg id for gen particles)
+// and sorted by eta, each jet then only testing the leptons in the eta window
+// [eta-dRmax, eta+dRmax]. The result is a keep-mask of the jet collection.
+// OverlapRemovalProducer stores it as a ValueMap, shared by all the modules.
+
+#include <cstddef>
+#include <vector>
+
+class OverlapRemoval
+{
+  public:
+    explicit OverlapRemoval(double dRmax = 0.01, double relPtMax = 0.01);
+
+    void clear();
+    // add the candidates c of cands with sel(c) to the lepton list
+    template<typename C, typename Sel>
+      void addLeptons(const C & cands, Sel sel);
+    template<typename C>
+      void addLeptons(const C & cands);
+    // to be called once all the leptons are added, before overlaps
+    void sort();
+
+    size_t nLeptons() const { return leptons_.size(); }
+    // true if an object with this pT, eta and phi overlaps with one of the leptons
+    bool overlaps(double pt, double eta, double phi) const;
+    // keep[i] = !overlaps(jets[i])
+    template<typename C>
+      void keepMask(const C & jets, std::vector<bool> & keep) const;
+
+  private:
+    struct Lepton {
+      double eta, phi, pt;
+      bool operator<(const Lepton & other) const { return eta < other.eta; }
+    };
+
+    double dRmax_, relPtMax_;
+    std::vector<Lepton> leptons_;
+};
+
+//
+// template member functions
+//
+
+template<typename C, typename Sel>
+  void
+OverlapRemoval::addLeptons(const C & cands, Sel sel)
+{
+  for (const auto & c : cands) {
+    if (!sel(c)) continue;
+    Lepton lepton;
+    lepton.eta = c.eta();
+    lepton.phi = c.phi();
+    lepton.pt = c.pt();
+    leptons_.push_back(lepton);
+  }
+}
+
+template<typename C>
+  void
+OverlapRemoval::addLeptons(const C & cands)
+{
+  typedef typename C::value_type Cand;
+  addLeptons(cands, [](const Cand &) { return true; });
+}
+
+template<typename C>
+  void
+OverlapRemoval::keepMask(const C & jets, std::vector<bool> & keep) const
+{
+  keep.assign(jets.size(), true);
+  if (leptons_.empty()) return;
+  size_t i = 0;
+  for (const auto & jet : jets) {
+    keep[i] = !overlaps(jet.pt(), jet.eta(), jet.phi());
+    i++;
+  }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _vertexcontext_h_
+#define _vertexcontext_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Common
+// Class:       VertexContext
+// Description: primary vertex and beamspot selected once per event
+//
+// Filled by VertexContextProducer: the primary vertex is the first vertex
+// of the collection which is not fake and has ndof > 4, its index being -1
+// if there is none. The ID producers and the modules reading their bits
+// take the vertex from there instead of each looping over the vertices.
+
+class VertexContext
+{
+  public:
+    VertexContext():
+      primaryVertex(-1), nGoodVertices(0), hasBeamSpot(false),
+      beamSpotX(0.), beamSpotY(0.), beamSpotZ(0.), beamSpotSigmaZ(0.) {}
+
+    bool hasPrimaryVertex() const { return primaryVertex >= 0; }
+
+    // index of the primary vertex in the vertex collection, -1 if none
+    int primaryVertex;
+    // number of vertices passing the primary vertex selection
+    unsigned nGoodVertices;
+
+    bool hasBeamSpot;
+    double beamSpotX, beamSpotY, beamSpotZ, beamSpotSigmaZ;
+};
+
+#endif
@@ -0,0 +1,145 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Common
+// Class:      LeptonJetCountFilter
+//
+/**\class LeptonJetCountFilter LeptonJetCountFilter.cc PhaseTwoAnalysis/Common/plugins/LeptonJetCountFilter.cc
+
+Description: keeps the events with at least minLeptons leptons and minJets jets passing pT and |eta| cuts
+
+Implementation:
+   - the leptons of all the collections in leptons are counted together, the jets of jets apart
+   - the counting stops as soon as the requirement is decided, i.e. when the minimum is reached or
+     the remaining candidates cannot reach it, and the jets are not read if the lepton requirement fails
+     (nor consumed if minJets is 0)
+   - no intermediate collection is produced, so that it replaces the CandPtrSelector, CandViewMerger and
+     CandViewCountFilter chain of the skim (preYieldFilter)
+   - used as a cheap prefilter on the raw RECO leptons (muons, ecalDrivenGsfElectrons) before PUPPI,
+     the jet reclustering and the HGCal rechits: the leptons and cuts are the ones of the final skim, so
+     it rejects exactly the events failing its lepton requirement; the jets are not tested, as no cut on
+     the uncorrected PF jets is guaranteed to be looser than the one on the corrected PUPPI jets
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <cmath>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+
+//
+// class declaration
+//
+
+class LeptonJetCountFilter : public edm::global::EDFilter<> {
+  public:
+    explicit LeptonJetCountFilter(const edm::ParameterSet&);
+    ~LeptonJetCountFilter();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // number of candidates of src passing the cuts, counting at most up to n; if last (no other
+    // collection adds to the count), stops as soon as the remaining candidates cannot reach n
+    static unsigned int countUpTo(const edm::View<reco::Candidate>& src, unsigned int n, double ptMin, double etaMax, bool last);
+
+    // ----------member data ---------------------------
+    std::vector<edm::EDGetTokenT<edm::View<reco::Candidate>>> leptonTokens_;
+    edm::EDGetTokenT<edm::View<reco::Candidate>> jetsToken_;
+    const unsigned int minLeptons_, minJets_;
+    const double leptonPtMin_, leptonEtaMax_;
+    const double jetPtMin_, jetEtaMax_;
+};
+
+//
+// constructors and destructor
+//
+LeptonJetCountFilter::LeptonJetCountFilter(const edm::ParameterSet& iConfig):
+  minLeptons_(iConfig.getParameter<unsigned int>("minLeptons")),
+  minJets_(iConfig.getParameter<unsigned int>("minJets")),
+  leptonPtMin_(iConfig.getParameter<double>("leptonPtMin")),
+  leptonEtaMax_(iConfig.getParameter<double>("leptonEtaMax")),
+  jetPtMin_(iConfig.getParameter<double>("jetPtMin")),
+  jetEtaMax_(iConfig.getParameter<double>("jetEtaMax"))
+{
+  for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("leptons"))
+    leptonTokens_.push_back(consumes<edm::View<reco::Candidate>>(tag));
+  if (minJets_ > 0) jetsToken_ = consumes<edm::View<reco::Candidate>>(iConfig.getParameter<edm::InputTag>("jets"));
+}
+
+
+LeptonJetCountFilter::~LeptonJetCountFilter()
+{
+}
+
+
+//
+// member functions
+//
+
+  unsigned int
+LeptonJetCountFilter::countUpTo(const edm::View<reco::Candidate>& src, unsigned int n, double ptMin, double etaMax, bool last)
+{
+  unsigned int count = 0;
+  for (size_t i = 0; i < src.size() && count < n; i++) {
+    if (last && count + (src.size() - i) < n) break;
+    const reco::Candidate & cand = src[i];
+    if (cand.pt() > ptMin && std::abs(cand.eta()) < etaMax) count++;
+  }
+  return count;
+}
+
+// ------------ method called on each new Event  ------------
+  bool
+LeptonJetCountFilter::filter(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  unsigned int nLeptons = 0;
+  for (size_t s = 0; s < leptonTokens_.size() && nLeptons < minLeptons_; s++) {
+    Handle<View<reco::Candidate>> leptons;
+    iEvent.getByToken(leptonTokens_[s], leptons);
+    nLeptons += countUpTo(*leptons, minLeptons_ - nLeptons, leptonPtMin_, leptonEtaMax_, s + 1 == leptonTokens_.size());
+  }
+  if (nLeptons < minLeptons_) return false;
+
+  if (minJets_ == 0) return true;
+  Handle<View<reco::Candidate>> jets;
+  iEvent.getByToken(jetsToken_, jets);
+  return countUpTo(*jets, minJets_, jetPtMin_, jetEtaMax_, true) == minJets_;
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+LeptonJetCountFilter::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::vector<edm::InputTag>>("leptons", std::vector<edm::InputTag>({edm::InputTag("muons"), edm::InputTag("ecalDrivenGsfElectrons")}));
+  desc.add<edm::InputTag>("jets", edm::InputTag("ak4PFJets"));
+  desc.add<unsigned int>("minLeptons", 1);
+  desc.add<unsigned int>("minJets", 2);
+  desc.add<double>("leptonPtMin", 10.);
+  desc.add<double>("leptonEtaMax", 3.);
+  desc.add<double>("jetPtMin", 10.);
+  desc.add<double>("jetEtaMax", 5.);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(LeptonJetCountFilter);
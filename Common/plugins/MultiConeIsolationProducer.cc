@@ -0,0 +1,205 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Common
+// Class:      MultiConeIsolationProducer
+//
+/**\class MultiConeIsolationProducer MultiConeIsolationProducer.cc PhaseTwoAnalysis/Common/plugins/MultiConeIsolationProducer.cc
+
+Description: computes charged, neutral and photon isolation sums for several cone sizes
+
+Implementation:
+   - all the objects to isolate (any number of collections) are gathered and sorted by eta
+   - the candidates are then visited once, each one being added to the sums of the objects
+     found in the eta window of the largest cone, whose deltaR are computed together (EtaPhiKernels)
+   - charged: candidates with a non-zero charge, photons: pdgId 22 or 2 (HF EM), neutral: the rest
+   - one edm::ValueMap<float> is published per collection, particle type and cone size, with the
+     instance name <label>-<h+|h0|gamma>-DR<100*R>, e.g. electrons-h+-DR040
+*/
+
+
+// system include files
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+
+#include "PhaseTwoAnalysis/Common/interface/EtaPhiKernels.h"
+
+//
+// class declaration
+//
+
+class MultiConeIsolationProducer : public edm::global::EDProducer<> {
+  public:
+    explicit MultiConeIsolationProducer(const edm::ParameterSet&);
+    ~MultiConeIsolationProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    enum IsolationType {CHARGED = 0, NEUTRAL, PHOTON, NTYPES};
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<edm::View<reco::Candidate>> pfCandsToken_;
+    std::vector<edm::EDGetTokenT<edm::View<reco::Candidate>>> srcTokens_;
+    std::vector<std::string> labels_;
+    std::vector<double> coneSizes_;
+    double vetoConeSize_;
+    // instance names, indexed by [collection][type*nCones + cone]
+    std::vector<std::vector<std::string>> instances_;
+};
+
+//
+// constructors and destructor
+//
+MultiConeIsolationProducer::MultiConeIsolationProducer(const edm::ParameterSet& iConfig):
+  pfCandsToken_(consumes<edm::View<reco::Candidate>>(iConfig.getParameter<edm::InputTag>("pfCands"))),
+  coneSizes_(iConfig.getParameter<std::vector<double>>("coneSizes")),
+  vetoConeSize_(iConfig.getParameter<double>("vetoConeSize"))
+{
+  const char* typeNames[NTYPES] = {"h+", "h0", "gamma"};
+  for (const edm::ParameterSet& pset : iConfig.getParameter<std::vector<edm::ParameterSet>>("srcToIsolate")) {
+    srcTokens_.push_back(consumes<edm::View<reco::Candidate>>(pset.getParameter<edm::InputTag>("src")));
+    labels_.push_back(pset.getParameter<std::string>("label"));
+    std::vector<std::string> names;
+    for (size_t t = 0; t < NTYPES; t++) {
+      for (size_t c = 0; c < coneSizes_.size(); c++) {
+        char name[16];
+        snprintf(name, sizeof(name), "-DR%03d", (int)std::round(coneSizes_[c]*100.));
+        names.push_back(labels_.back() + "-" + typeNames[t] + name);
+        produces<edm::ValueMap<float>>(names.back());
+      }
+    }
+    instances_.push_back(names);
+  }
+}
+
+
+MultiConeIsolationProducer::~MultiConeIsolationProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+MultiConeIsolationProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  const size_t nCones = coneSizes_.size();
+  double maxCone = 0.;
+  std::vector<double> cone2(nCones);
+  for (size_t c = 0; c < nCones; c++) {
+    cone2[c] = coneSizes_[c]*coneSizes_[c];
+    maxCone = std::max(maxCone, coneSizes_[c]);
+  }
+  const double veto2 = vetoConeSize_*vetoConeSize_;
+
+  // Objects to isolate, sorted by eta
+  std::vector<Handle<View<reco::Candidate>>> srcs(srcTokens_.size());
+  std::vector<std::vector<double>> sums(srcTokens_.size());
+  std::vector<float> objEta, objPhi;
+  std::vector<std::pair<unsigned, unsigned>> objRef;
+  for (size_t s = 0; s < srcTokens_.size(); s++) {
+    iEvent.getByToken(srcTokens_[s], srcs[s]);
+    sums[s].assign(srcs[s]->size()*NTYPES*nCones, 0.);
+    for (size_t i = 0; i < srcs[s]->size(); i++) {
+      objEta.push_back(srcs[s]->at(i).eta());
+      objPhi.push_back(srcs[s]->at(i).phi());
+      objRef.push_back(std::make_pair(s, i));
+    }
+  }
+  std::vector<unsigned> order(objEta.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return objEta[a] < objEta[b]; });
+  std::vector<float> sortedEta(order.size()), sortedPhi(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    sortedEta[i] = objEta[order[i]];
+    sortedPhi[i] = objPhi[order[i]];
+  }
+  std::vector<float> dR2s(order.size());
+
+  // Single pass over the candidates
+  Handle<View<reco::Candidate>> pfCands;
+  iEvent.getByToken(pfCandsToken_, pfCands);
+  if (!order.empty()) {
+    for (size_t k = 0; k < pfCands->size(); k++) {
+      const reco::Candidate & cand = pfCands->at(k);
+      const float eta = cand.eta();
+      const float phi = cand.phi();
+      const double pt = cand.pt();
+      int type = NEUTRAL;
+      if (cand.charge() != 0) type = CHARGED;
+      else if (cand.pdgId() == 22 || cand.pdgId() == 2) type = PHOTON;
+
+      const size_t lo = std::lower_bound(sortedEta.begin(), sortedEta.end(), eta - (float)maxCone) - sortedEta.begin();
+      const size_t hi = std::upper_bound(sortedEta.begin() + lo, sortedEta.end(), eta + (float)maxCone) - sortedEta.begin();
+      if (lo == hi) continue;
+      etaphi::deltaR2(&sortedEta[lo], &sortedPhi[lo], hi - lo, eta, phi, &dR2s[lo]);
+      for (size_t o = lo; o < hi; o++) {
+        const double dR2 = dR2s[o];
+        if (dR2 < veto2) continue;
+        const unsigned obj = order[o];
+        double* objSums = &sums[objRef[obj].first][(objRef[obj].second*NTYPES + type)*nCones];
+        for (size_t c = 0; c < nCones; c++)
+          if (dR2 <= cone2[c]) objSums[c] += pt;
+      }
+    }
+  }
+
+  // Value maps
+  for (size_t s = 0; s < srcTokens_.size(); s++) {
+    const size_t n = srcs[s]->size();
+    for (size_t t = 0; t < NTYPES; t++) {
+      for (size_t c = 0; c < nCones; c++) {
+        std::vector<float> values(n);
+        for (size_t i = 0; i < n; i++) values[i] = sums[s][(i*NTYPES + t)*nCones + c];
+        std::unique_ptr<ValueMap<float>> valueMap(new ValueMap<float>());
+        ValueMap<float>::Filler filler(*valueMap);
+        filler.insert(srcs[s], values.begin(), values.end());
+        filler.fill();
+        iEvent.put(std::move(valueMap), instances_[s][t*nCones + c]);
+      }
+    }
+  }
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MultiConeIsolationProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("pfCands", edm::InputTag("particleFlow"));
+  edm::ParameterSetDescription srcDesc;
+  srcDesc.add<std::string>("label");
+  srcDesc.add<edm::InputTag>("src");
+  desc.addVPSet("srcToIsolate", srcDesc);
+  desc.add<std::vector<double>>("coneSizes", std::vector<double>({0.2, 0.3, 0.4}));
+  desc.add<double>("vetoConeSize", 0.);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MultiConeIsolationProducer);
@@ -0,0 +1,134 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Common
+// Class:      OverlapRemovalProducer
+//
+/**\class OverlapRemovalProducer OverlapRemovalProducer.cc PhaseTwoAnalysis/Common/plugins/OverlapRemovalProducer.cc
+
+Description: computes once per event which jets are a copy of a lepton, stored as an edm::ValueMap<bool>
+(true if the jet is kept, i.e. it overlaps with none of the leptons)
+
+Implementation:
+   - a jet overlaps with a lepton when |pT(jet) - pT(lep)| < relPtMax * pT(lep) and deltaR < dRmax (see OverlapRemoval)
+   - the leptons of all the collections in leptons are gathered together, keeping only the |pdgId| listed in pdgIds
+     if not empty (e.g. the electrons and muons of the gen particles), and sorted by eta once
+   - any collection readable as edm::View<reco::Candidate> can be used for the jets and the leptons
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+
+#include "PhaseTwoAnalysis/Common/interface/OverlapRemoval.h"
+
+//
+// class declaration
+//
+
+class OverlapRemovalProducer : public edm::global::EDProducer<> {
+  public:
+    explicit OverlapRemovalProducer(const edm::ParameterSet&);
+    ~OverlapRemovalProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<edm::View<reco::Candidate>> jetsToken_;
+    std::vector<edm::EDGetTokenT<edm::View<reco::Candidate>>> leptonTokens_;
+    std::vector<int> pdgIds_;
+    const double dRmax_, relPtMax_;
+};
+
+//
+// constructors and destructor
+//
+OverlapRemovalProducer::OverlapRemovalProducer(const edm::ParameterSet& iConfig):
+  jetsToken_(consumes<edm::View<reco::Candidate>>(iConfig.getParameter<edm::InputTag>("jets"))),
+  pdgIds_(iConfig.getParameter<std::vector<int>>("pdgIds")),
+  dRmax_(iConfig.getParameter<double>("dRmax")),
+  relPtMax_(iConfig.getParameter<double>("relPtMax"))
+{
+  for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("leptons"))
+    leptonTokens_.push_back(consumes<edm::View<reco::Candidate>>(tag));
+  for (int & pdgId : pdgIds_) pdgId = std::abs(pdgId);
+
+  produces<edm::ValueMap<bool>>();
+}
+
+
+OverlapRemovalProducer::~OverlapRemovalProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+OverlapRemovalProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  Handle<View<reco::Candidate>> jets;
+  iEvent.getByToken(jetsToken_, jets);
+
+  OverlapRemoval overlapRemoval(dRmax_, relPtMax_);
+  for (const EDGetTokenT<View<reco::Candidate>> & token : leptonTokens_) {
+    Handle<View<reco::Candidate>> leptons;
+    iEvent.getByToken(token, leptons);
+    if (pdgIds_.empty()) overlapRemoval.addLeptons(*leptons);
+    else overlapRemoval.addLeptons(*leptons, [this](const reco::Candidate & c) {
+        return std::find(pdgIds_.begin(), pdgIds_.end(), std::abs(c.pdgId())) != pdgIds_.end();
+      });
+  }
+  overlapRemoval.sort();
+
+  std::vector<bool> keep;
+  overlapRemoval.keepMask(*jets, keep);
+
+  std::unique_ptr<ValueMap<bool>> valueMap(new ValueMap<bool>());
+  ValueMap<bool>::Filler filler(*valueMap);
+  filler.insert(jets, keep.begin(), keep.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+OverlapRemovalProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("jets", edm::InputTag("ak4PFJetsCHS"));
+  desc.add<std::vector<edm::InputTag>>("leptons", std::vector<edm::InputTag>({edm::InputTag("muons"), edm::InputTag("ecalDrivenGsfElectrons")}));
+  desc.add<std::vector<int>>("pdgIds", std::vector<int>());
+  desc.add<double>("dRmax", 0.01);
+  desc.add<double>("relPtMax", 0.01);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(OverlapRemovalProducer);
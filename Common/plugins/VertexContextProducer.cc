@@ -0,0 +1,117 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Common
+// Class:      VertexContextProducer
+//
+/**\class VertexContextProducer VertexContextProducer.cc PhaseTwoAnalysis/Common/plugins/VertexContextProducer.cc
+
+Description: selects once per event the primary vertex and the beamspot, stored as a VertexContext
+
+Implementation:
+   - the primary vertex is the first vertex which is not fake and has ndof > 4 (index -1 if none),
+     as was done in each of the modules, the number of such vertices is kept as well
+   - the beamspot is optional, hasBeamSpot being false if it is not in the event
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
+//
+// class declaration
+//
+
+class VertexContextProducer : public edm::global::EDProducer<> {
+  public:
+    explicit VertexContextProducer(const edm::ParameterSet&);
+    ~VertexContextProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
+    edm::EDGetTokenT<reco::BeamSpot> bsToken_;
+};
+
+//
+// constructors and destructor
+//
+VertexContextProducer::VertexContextProducer(const edm::ParameterSet& iConfig):
+  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
+  bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot")))
+{
+  produces<VertexContext>();
+}
+
+
+VertexContextProducer::~VertexContextProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+VertexContextProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  Handle<std::vector<reco::Vertex>> vertices;
+  iEvent.getByToken(verticesToken_, vertices);
+  Handle<reco::BeamSpot> beamspot;
+  iEvent.getByToken(bsToken_, beamspot);
+
+  std::unique_ptr<VertexContext> context(new VertexContext());
+  for (size_t i = 0; i < vertices->size(); i++) {
+    if (vertices->at(i).isFake() || vertices->at(i).ndof() <= 4) continue;
+    if (context->primaryVertex < 0) context->primaryVertex = i;
+    context->nGoodVertices++;
+  }
+
+  if (beamspot.isValid()) {
+    context->hasBeamSpot = true;
+    context->beamSpotX = beamspot->x0();
+    context->beamSpotY = beamspot->y0();
+    context->beamSpotZ = beamspot->z0();
+    context->beamSpotSigmaZ = beamspot->sigmaZ();
+  }
+
+  iEvent.put(std::move(context));
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+VertexContextProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("vertices", edm::InputTag("offlinePrimaryVertices"));
+  desc.add<edm::InputTag>("beamspot", edm::InputTag("offlineBeamSpot"));
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(VertexContextProducer);
@@ -0,0 +1,12 @@
+import FWCore.ParameterSet.Config as cms
+
+# cheap prefilter on the raw RECO collections, run before the skim (preYieldFilter): the same leptons
+# and lepton cuts, and no jet requirement, as the raw PF jets cannot be cut on conservatively with
+# respect to the corrected PUPPI jets of the skim
+recoPrefilter = cms.EDFilter('LeptonJetCountFilter',
+        leptons      = cms.VInputTag("muons", "ecalDrivenGsfElectrons"),
+        minLeptons   = cms.uint32(1),
+        minJets      = cms.uint32(0),
+        leptonPtMin  = cms.double(10.),
+        leptonEtaMax = cms.double(3.),
+)
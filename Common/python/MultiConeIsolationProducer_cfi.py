@@ -0,0 +1,11 @@
+import FWCore.ParameterSet.Config as cms
+
+leptonIsolation = cms.EDProducer('MultiConeIsolationProducer',
+        pfCands      = cms.InputTag("particleFlow"),
+        srcToIsolate = cms.VPSet(
+            cms.PSet( label = cms.string("electrons"),
+                      src   = cms.InputTag("ecalDrivenGsfElectrons") ),
+        ),
+        coneSizes    = cms.vdouble(0.2, 0.3, 0.4),
+        vetoConeSize = cms.double(0.),
+)
@@ -0,0 +1,27 @@
+import FWCore.ParameterSet.Config as cms
+
+# jets which are a copy of a lepton (same pT within 1%, deltaR < 0.01), computed once per event
+# (ValueMap<bool>, true if the jet is kept)
+jetLeptonOverlaps = cms.EDProducer('OverlapRemovalProducer',
+        jets     = cms.InputTag("ak4PFJetsCHS"),
+        leptons  = cms.VInputTag("muons", "ecalDrivenGsfElectrons"),
+        pdgIds   = cms.vint32(),
+        dRmax    = cms.double(0.01),
+        relPtMax = cms.double(0.01),
+)
+
+genJetLeptonOverlaps = jetLeptonOverlaps.clone(
+        jets     = cms.InputTag("ak4GenJets"),
+        leptons  = cms.VInputTag("genParticles"),
+        pdgIds   = cms.vint32(11, 13),
+)
+
+patJetLeptonOverlaps = jetLeptonOverlaps.clone(
+        jets     = cms.InputTag("slimmedJetsPuppi"),
+        leptons  = cms.VInputTag("slimmedMuons", "slimmedElectrons"),
+)
+
+patGenJetLeptonOverlaps = genJetLeptonOverlaps.clone(
+        jets     = cms.InputTag("slimmedGenJets"),
+        leptons  = cms.VInputTag("packedGenParticles"),
+)
@@ -0,0 +1,11 @@
+import FWCore.ParameterSet.Config as cms
+
+# primary vertex (first non-fake vertex with ndof > 4) and beamspot, selected once per event
+vertexContext = cms.EDProducer('VertexContextProducer',
+        vertices = cms.InputTag("offlinePrimaryVertices"),
+        beamspot = cms.InputTag("offlineBeamSpot"),
+)
+
+patVertexContext = vertexContext.clone(
+        vertices = cms.InputTag("offlineSlimmedPrimaryVertices"),
+)
@@ -0,0 +1,39 @@
+#include "PhaseTwoAnalysis/Common/interface/DeltaRMatcher.h"
+
+#include <algorithm>
+
+#include "PhaseTwoAnalysis/Common/interface/EtaPhiKernels.h"
+
+void
+DeltaRMatcher::assign()
+{
+  const size_t nReco = recoEta_.size();
+  const size_t nGen = genEta_.size();
+  const float dR2max = dRmax_*dRmax_;
+
+  pairs_.clear();
+  dR2Row_.resize(nGen);
+  for (size_t i = 0; i < nReco; i++) {
+    etaphi::deltaR2(genEta_.data(), genPhi_.data(), nGen, recoEta_[i], recoPhi_[i], dR2Row_.data());
+    for (size_t j = 0; j < nGen; j++) {
+      if (dR2Row_[j] > dR2max) continue;
+      Pair pair;
+      pair.dR2 = dR2Row_[j];
+      pair.reco = i;
+      pair.gen = j;
+      pairs_.push_back(pair);
+    }
+  }
+  std::sort(pairs_.begin(), pairs_.end());
+
+  result_.assign(nReco, -1);
+  genTaken_.assign(nGen, false);
+  size_t nLeft = std::min(nReco, nGen);
+  for (const Pair & pair : pairs_) {
+    if (nLeft == 0) break;
+    if (result_[pair.reco] >= 0 || genTaken_[pair.gen]) continue;
+    result_[pair.reco] = genKey_[pair.gen];
+    genTaken_[pair.gen] = true;
+    nLeft--;
+  }
+}
@@ -0,0 +1,111 @@
+#include "PhaseTwoAnalysis/Common/interface/EtaPhiKernels.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+  const float kPi = M_PI;
+  const float kTwoPi = 2*M_PI;
+
+  inline float
+  deltaR2Scalar(float eta, float phi, float eta0, float phi0)
+  {
+    const float dEta = eta - eta0;
+    float dPhi = phi - phi0;
+    if (dPhi > kPi) dPhi -= kTwoPi;
+    else if (dPhi <= -kPi) dPhi += kTwoPi;
+    return dEta*dEta + dPhi*dPhi;
+  }
+
+#if defined(__SSE2__)
+  // deltaR^2 of the four entries at eta, phi
+  inline __m128
+  deltaR2Sse(const float * eta, const float * phi, __m128 eta0, __m128 phi0)
+  {
+    const __m128 pi = _mm_set1_ps(kPi);
+    const __m128 minusPi = _mm_set1_ps(-kPi);
+    const __m128 twoPi = _mm_set1_ps(kTwoPi);
+    const __m128 dEta = _mm_sub_ps(_mm_loadu_ps(eta), eta0);
+    __m128 dPhi = _mm_sub_ps(_mm_loadu_ps(phi), phi0);
+    dPhi = _mm_sub_ps(dPhi, _mm_and_ps(_mm_cmpgt_ps(dPhi, pi), twoPi));
+    dPhi = _mm_add_ps(dPhi, _mm_and_ps(_mm_cmple_ps(dPhi, minusPi), twoPi));
+    return _mm_add_ps(_mm_mul_ps(dEta, dEta), _mm_mul_ps(dPhi, dPhi));
+  }
+#endif
+}
+
+namespace etaphi {
+
+  void
+  deltaR2(const float * eta, const float * phi, size_t n, float eta0, float phi0, float * out)
+  {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 veta0 = _mm_set1_ps(eta0);
+    const __m128 vphi0 = _mm_set1_ps(phi0);
+    for (; i + 4 <= n; i += 4)
+      _mm_storeu_ps(out + i, deltaR2Sse(eta + i, phi + i, veta0, vphi0));
+#endif
+    for (; i < n; i++) out[i] = deltaR2Scalar(eta[i], phi[i], eta0, phi0);
+  }
+
+  double
+  sumPtInCone(const float * eta, const float * phi, const float * pt, size_t n,
+              float eta0, float phi0, float dRmax, float dRmin)
+  {
+    const float dR2max = dRmax*dRmax;
+    const float dR2min = dRmin*dRmin;
+    double sum = 0.;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 veta0 = _mm_set1_ps(eta0);
+    const __m128 vphi0 = _mm_set1_ps(phi0);
+    const __m128 vmax = _mm_set1_ps(dR2max);
+    const __m128 vmin = _mm_set1_ps(dR2min);
+    // the masked pTs are converted to double and summed in double, as in the scalar loop
+    __m128d accLow = _mm_setzero_pd();
+    __m128d accHigh = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+      const __m128 dR2 = deltaR2Sse(eta + i, phi + i, veta0, vphi0);
+      const __m128 in = _mm_and_ps(_mm_cmple_ps(dR2, vmax), _mm_cmpge_ps(dR2, vmin));
+      const __m128 ptIn = _mm_and_ps(in, _mm_loadu_ps(pt + i));
+      accLow = _mm_add_pd(accLow, _mm_cvtps_pd(ptIn));
+      accHigh = _mm_add_pd(accHigh, _mm_cvtps_pd(_mm_movehl_ps(ptIn, ptIn)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(accLow, accHigh));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+      const float dR2 = deltaR2Scalar(eta[i], phi[i], eta0, phi0);
+      if (dR2 <= dR2max && dR2 >= dR2min) sum += pt[i];
+    }
+    return sum;
+  }
+
+  int
+  nearest(const float * eta, const float * phi, size_t n,
+          float eta0, float phi0, float dRmax, float * dR2)
+  {
+    // deltaR^2 computed by blocks with the vector kernel, then scanned in order
+    const size_t kBlock = 64;
+    float block[kBlock];
+    int best = -1;
+    float bestDR2 = dRmax*dRmax;
+    for (size_t first = 0; first < n; first += kBlock) {
+      const size_t m = (n - first < kBlock ? n - first : kBlock);
+      deltaR2(eta + first, phi + first, m, eta0, phi0, block);
+      for (size_t i = 0; i < m; i++) {
+        if (block[i] > bestDR2 || (best >= 0 && block[i] == bestDR2)) continue;
+        bestDR2 = block[i];
+        best = first + i;
+      }
+    }
+    if (dR2 && best >= 0) *dR2 = bestDR2;
+    return best;
+  }
+
+}
@@ -0,0 +1,29 @@
+#include "PhaseTwoAnalysis/Common/interface/GenJetConstituents.h"
+
+#include "DataFormats/Math/interface/deltaR.h"
+#include "PhaseTwoAnalysis/Common/interface/EtaPhiKernels.h"
+
+void
+GenJetConstituents::clear()
+{
+  jetEta_.clear();
+  jetPhi_.clear();
+  jetBegin_.assign(1, 0);
+  eta_.clear();
+  phi_.clear();
+  pt_.clear();
+}
+
+double
+GenJetConstituents::sumPt(float eta, float phi, float dRjet, float dRmin, float dRmax) const
+{
+  const float dR2jet = dRjet*dRjet;
+  double sum = 0.;
+  for (size_t j = 0; j < jetEta_.size(); j++) {
+    if (reco::deltaR2(eta, phi, jetEta_[j], jetPhi_[j]) > dR2jet) continue;
+    const unsigned begin = jetBegin_[j];
+    sum += etaphi::sumPtInCone(eta_.data() + begin, phi_.data() + begin, pt_.data() + begin,
+                               jetBegin_[j+1] - begin, eta, phi, dRmax, dRmin);
+  }
+  return sum;
+}
@@ -0,0 +1,40 @@
+#include "PhaseTwoAnalysis/Common/interface/KinematicsSoA.h"
+
+void
+KinematicsSoA::clear()
+{
+  eta_.clear();
+  phi_.clear();
+  pt_.clear();
+  key_.clear();
+}
+
+void
+KinematicsSoA::push_back(float eta, float phi, float pt, unsigned key)
+{
+  eta_.push_back(eta);
+  phi_.push_back(phi);
+  pt_.push_back(pt);
+  key_.push_back(key);
+}
+
+void
+KinematicsSoA::deltaR2(float eta, float phi, FloatVector & out) const
+{
+  out.resize(eta_.size());
+  etaphi::deltaR2(eta_.data(), phi_.data(), eta_.size(), eta, phi, out.data());
+}
+
+double
+KinematicsSoA::sumPtInCone(float eta, float phi, float dRmax, float dRmin) const
+{
+  return etaphi::sumPtInCone(eta_.data(), phi_.data(), pt_.data(), eta_.size(), eta, phi, dRmax, dRmin);
+}
+
+int
+KinematicsSoA::nearest(float eta, float phi, float dRmax) const
+{
+  // entries are stored in increasing key order, the lowest index is the lowest key
+  const int i = etaphi::nearest(eta_.data(), phi_.data(), eta_.size(), eta, phi, dRmax);
+  return (i < 0 ? -1 : (int)key_[i]);
+}
@@ -0,0 +1,37 @@
+#include "PhaseTwoAnalysis/Common/interface/OverlapRemoval.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "DataFormats/Math/interface/deltaR.h"
+
+OverlapRemoval::OverlapRemoval(double dRmax, double relPtMax):
+  dRmax_(dRmax), relPtMax_(relPtMax)
+{
+}
+
+void
+OverlapRemoval::clear()
+{
+  leptons_.clear();
+}
+
+void
+OverlapRemoval::sort()
+{
+  std::sort(leptons_.begin(), leptons_.end());
+}
+
+bool
+OverlapRemoval::overlaps(double pt, double eta, double phi) const
+{
+  Lepton low;
+  low.eta = eta - dRmax_;
+  const double dR2max = dRmax_*dRmax_;
+  for (std::vector<Lepton>::const_iterator it = std::lower_bound(leptons_.begin(), leptons_.end(), low);
+       it != leptons_.end() && it->eta <= eta + dRmax_; ++it) {
+    if (std::abs(pt - it->pt) >= relPtMax_*it->pt) continue;
+    if (reco::deltaR2(it->eta, it->phi, eta, phi) < dR2max) return true;
+  }
+  return false;
+}
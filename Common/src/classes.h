@@ -0,0 +1,9 @@
+#include "DataFormats/Common/interface/Wrapper.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
+namespace PhaseTwoAnalysis_Common {
+  struct dictionary {
+    VertexContext vtxContext;
+    edm::Wrapper<VertexContext> wvtxContext;
+  };
+}
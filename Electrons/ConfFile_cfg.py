@@ -46,7 +46,10 @@ process.load('CommonTools/PileupAlgos/softKiller_cfi')
 from CommonTools.PileupAlgos.PhotonPuppi_cff        import setupPuppiPhoton
 from PhysicsTools.PatAlgos.slimming.puppiForMET_cff import makePuppies
 makePuppies(process)
-process.puSequence = cms.Sequence(process.pfNoLepPUPPI * process.puppiNoLep)
+# lepton isolation sums, computed in a single pass over the no-lepton PUPPI candidates
+process.load("PhaseTwoAnalysis.Common.MultiConeIsolationProducer_cfi")
+process.leptonIsolation.pfCands = cms.InputTag("puppiNoLep")
+process.puSequence = cms.Sequence(process.pfNoLepPUPPI * process.puppiNoLep * process.leptonIsolation)
 
 # PF cluster producer for HFCal ID
 process.load('Configuration.Geometry.GeometryExtended2023D17Reco_cff')
@@ -65,8 +68,10 @@ if (options.inputFormat.lower() == "reco"):
     moduleName = "RecoElectronFilter"
 process.electronfilter = cms.EDProducer(moduleName)
 process.load("PhaseTwoAnalysis.Electrons."+moduleName+"_cfi")
-if (options.inputFormat.lower() == "reco"):
-    process.electronfilter.pfCandsNoLep = "puppiNoLep"
+# conversion veto, primary vertex and electron ID working points, computed once per event
+process.load("PhaseTwoAnalysis.Electrons.ConversionVetoProducer_cfi")
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Electrons.ElectronIDProducer_cfi")
 
 process.out = cms.OutputModule("PoolOutputModule",
     outputCommands = cms.untracked.vstring('keep *_*_*_*',
@@ -76,8 +81,8 @@ process.out = cms.OutputModule("PoolOutputModule",
 )
   
 if (options.inputFormat.lower() == "reco"):
-    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.electronfilter)
+    process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.conversionVeto * process.vertexContext * process.electronID * process.electronfilter)
 else:
-    process.p = cms.Path(process.electronfilter)
+    process.p = cms.Path(process.patConversionVeto * process.patElectronID * process.electronfilter)
 
 process.e = cms.EndPath(process.out)
@@ -0,0 +1,173 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Electrons
+// Program:    convertElectronMVAForest
+//
+// Converts a TMVA BDT weights file into the binary forest file read by
+// ElectronMVAForest, and checks that TMVA::Reader, the forest read from XML
+// and the binary forest give the same scores, bit for bit; the forest file
+// is only created if they do:
+//   convertElectronMVAForest TMVAClassification_BDT.weights.xml TMVAClassification_BDT.forest
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TMVA/Reader.h"
+
+#include "PhaseTwoAnalysis/Electrons/interface/ElectronMVAForest.h"
+
+namespace {
+
+  // expressions of the spectators of a TMVA weights file, in SpecIndex order
+  std::vector<std::string>
+    spectators(const std::string &fileName)
+    {
+      std::ifstream in(fileName.c_str());
+      std::stringstream buffer;
+      buffer << in.rdbuf();
+      const std::string text = buffer.str();
+      std::vector<std::string> names;
+      for (size_t pos = text.find("<Spectator "); pos != std::string::npos; pos = text.find("<Spectator ", pos + 1)) {
+        const size_t begin = text.find("Expression=\"", pos) + 12;
+        names.push_back(text.substr(begin, text.find('"', begin) - begin));
+      }
+      return names;
+    }
+
+  // inputs on both sides of every cut: for each node, x[var] = cut and the floats just below and
+  // above it, the other variables being cuts of random nodes on them; then NaN and +-inf in turn
+  // in each variable, and inputs uniformly distributed between the smallest and largest cuts
+  std::vector<float>
+    testInputs(const ElectronMVAForest &forest)
+    {
+      const size_t nVars = forest.variables().size();
+      const ElectronMVAForest::Node *nodes = forest.nodes();
+      std::vector<std::vector<float>> cuts(nVars);
+      for (size_t i = 0; i < forest.nNodes(); i++)
+        if (nodes[i].var >= 0) cuts[nodes[i].var].push_back(nodes[i].cut);
+
+      std::srand(1);
+      std::vector<float> x;
+      std::vector<float> in(nVars);
+      auto randomCuts = [&]() {
+        for (size_t v = 0; v < nVars; v++)
+          in[v] = cuts[v].empty() ? 0.f : cuts[v][std::rand() % cuts[v].size()];
+      };
+
+      const float inf = std::numeric_limits<float>::infinity();
+      for (size_t i = 0; i < forest.nNodes(); i++) {
+        if (nodes[i].var < 0) continue;
+        const float cut = nodes[i].cut;
+        const float edges[3] = {cut, std::nextafter(cut, -inf), std::nextafter(cut, inf)};
+        for (float edge : edges) {
+          randomCuts();
+          in[nodes[i].var] = edge;
+          x.insert(x.end(), in.begin(), in.end());
+        }
+      }
+      const float specials[3] = {std::numeric_limits<float>::quiet_NaN(), inf, -inf};
+      for (size_t v = 0; v < nVars; v++) {
+        for (float special : specials) {
+          randomCuts();
+          in[v] = special;
+          x.insert(x.end(), in.begin(), in.end());
+        }
+      }
+      for (size_t n = 0; n < 10000; n++) {
+        for (size_t v = 0; v < nVars; v++) {
+          float lo = 0.f, hi = 0.f;
+          for (size_t c = 0; c < cuts[v].size(); c++) {
+            if (c == 0 || cuts[v][c] < lo) lo = cuts[v][c];
+            if (c == 0 || cuts[v][c] > hi) hi = cuts[v][c];
+          }
+          in[v] = lo + (hi - lo)*((float)std::rand()/RAND_MAX);
+        }
+        x.insert(x.end(), in.begin(), in.end());
+      }
+      return x;
+    }
+
+  bool
+    sameScores(const char *name, const std::vector<double> &a, const std::vector<double> &b)
+    {
+      for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i]) {
+          std::fprintf(stderr, "%s: different scores for input %zu: %.17g %.17g\n", name, i, a[i], b[i]);
+          return false;
+        }
+      }
+      return true;
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 3) {
+    std::fprintf(stderr, "usage: %s <TMVA weights xml> <forest file>\n", argv[0]);
+    return 1;
+  }
+
+  ElectronMVAForest xml(argv[1]);
+  if (!xml.isValid()) {
+    std::fprintf(stderr, "%s\n", xml.error().c_str());
+    return 1;
+  }
+  // written next to the output and renamed once checked
+  const std::string tmpName = std::string(argv[2]) + ".tmp";
+  if (!xml.write(tmpName)) {
+    std::fprintf(stderr, "cannot write %s\n", tmpName.c_str());
+    std::remove(tmpName.c_str());
+    return 1;
+  }
+
+  ElectronMVAForest binary(tmpName);
+  if (!binary.isValid() || !binary.isMapped()) {
+    std::fprintf(stderr, "%s\n", binary.error().c_str());
+    std::remove(tmpName.c_str());
+    return 1;
+  }
+
+  // reference scores of TMVA, the spectators being booked but not used
+  const size_t nVars = xml.variables().size();
+  std::vector<float> in(nVars);
+  const std::vector<std::string> spectatorNames = spectators(argv[1]);
+  std::vector<float> spectatorValues(spectatorNames.size(), 0.f);
+  TMVA::Reader reader("!Color:Silent:!Error");
+  for (size_t v = 0; v < nVars; v++) reader.AddVariable(xml.variables()[v], &in[v]);
+  for (size_t s = 0; s < spectatorNames.size(); s++) reader.AddSpectator(spectatorNames[s], &spectatorValues[s]);
+  if (!reader.BookMVA("BDT", argv[1])) {
+    std::fprintf(stderr, "TMVA cannot read %s\n", argv[1]);
+    std::remove(tmpName.c_str());
+    return 1;
+  }
+
+  const std::vector<float> x = testInputs(xml);
+  const size_t n = x.size()/nVars;
+  std::vector<double> tmva(n), a(n), b(n);
+  for (size_t i = 0; i < n; i++) {
+    in.assign(x.begin() + i*nVars, x.begin() + (i+1)*nVars);
+    tmva[i] = reader.EvaluateMVA("BDT");
+  }
+  xml.evaluate(x.data(), n, a.data());
+  binary.evaluate(x.data(), n, b.data());
+  if (!sameScores("TMVA::Reader and XML forest", tmva, a) || !sameScores("XML and binary forests", a, b)) {
+    std::remove(tmpName.c_str());
+    return 1;
+  }
+  if (std::rename(tmpName.c_str(), argv[2]) != 0) {
+    std::fprintf(stderr, "cannot rename %s to %s\n", tmpName.c_str(), argv[2]);
+    std::remove(tmpName.c_str());
+    return 1;
+  }
+
+  std::printf("%s: %zu trees, %zu nodes, %zu variables, same scores as TMVA::Reader for %zu inputs\n",
+              argv[2], binary.nTrees(), binary.nNodes(), nVars, n);
+  return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef _electronmvaforest_h_
+#define _electronmvaforest_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Electrons
+// Class:       ElectronMVAForest
+// Description: compiled evaluator of the TMVA BDT of the HGCal electron ID
+//
+// The TMVA weights XML is converted once into a flat array of 16-byte nodes,
+// the trees being laid out one after the other (pre-order). A node sends the
+// inputs with x[var] >= cut to child[1] and the others to child[0], the
+// children of the nodes with cType = 0 being swapped, which is the TMVA
+// DecisionTreeNode::GoesRight rule. The score is the TMVA AdaBoost one,
+// sum(boostWeight*leaf)/sum(boostWeight), with the same float cuts and the
+// same summation order, so that it is bit-identical to TMVA::Reader.
+// Evaluation is const: one forest can be shared by all the streams (see get).
+//
+// The forest can also be written to a binary file (see write and the
+// convertElectronMVAForest program), which is memory-mapped instead of parsed:
+//   - header: the 8 characters "EMVAFOR1", the numbers of variables, trees and
+//     nodes and the size of the variable names (uint32), and the FNV-1a checksum
+//     of the rest of the file (uint64)
+//   - the boost weights (double) and the root nodes (uint32) of the trees, the
+//     nodes, and the variable names, each one followed by a null character
+// in the byte order of the machine writing the file. The constructor reads
+// both formats.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+class ElectronMVAForest
+{
+  public:
+    // loads a TMVA BDT weights file or maps a binary forest file, see isValid
+    explicit ElectronMVAForest(const std::string &fileName);
+    ~ElectronMVAForest();
+
+    // forest shared by all the callers asking for the same file, loaded at the first call
+    static std::shared_ptr<const ElectronMVAForest> get(const std::string &fileName);
+
+    // false if the file could not be read or is not a supported BDT (AdaBoost, no Fisher cuts, no transformation)
+    bool isValid() const { return nTrees_ != 0; }
+    // reason why the forest is not valid
+    const std::string & error() const { return error_; }
+
+    // input variables (TMVA expressions), in the order expected by evaluate
+    const std::vector<std::string> & variables() const { return variables_; }
+    size_t nTrees() const { return nTrees_; }
+    size_t nNodes() const { return nNodes_; }
+    // true if the forest was mapped from a binary file
+    bool isMapped() const { return map_ != 0; }
+
+    // writes the binary forest file, false if the file cannot be written
+    bool write(const std::string &fileName) const;
+
+    // score of one input; -999 if one of the inputs is NaN, as TMVA::Reader
+    double evaluate(const float *x) const;
+    // scores of n inputs stored one after the other (n x variables().size() floats),
+    // the trees being visited once for the whole batch
+    void evaluate(const float *x, size_t n, double *scores) const;
+
+    struct Node {
+      float cut;            // cut value, or leaf response for the leaves
+      int16_t var;          // input variable, -1 for the leaves
+      uint16_t unused;
+      uint32_t child[2];    // x[var] < cut, x[var] >= cut
+    };
+    // nodes of all the trees, nNodes() of them
+    const Node * nodes() const { return nodes_; }
+
+  private:
+    ElectronMVAForest(const ElectronMVAForest&);
+    ElectronMVAForest& operator=(const ElectronMVAForest&);
+
+    bool parse(const std::string &text);
+    bool map(int fd, size_t size);
+
+    std::vector<std::string> variables_;
+    // storage of a forest read from XML, empty for a mapped one
+    std::vector<Node> nodeStore_;
+    std::vector<uint32_t> rootStore_;
+    std::vector<double> weightStore_;
+
+    const Node *nodes_;
+    const uint32_t *roots_;
+    const double *boostWeights_;
+    size_t nTrees_, nNodes_;
+    double norm_;
+    void *map_;
+    size_t mapSize_;
+    std::string error_;
+};
+
+#endif
@@ -0,0 +1,149 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Electrons
+// Class:      ConversionVetoProducer
+//
+/**\class ConversionVetoProducer ConversionVetoProducer.cc PhaseTwoAnalysis/Electrons/plugins/ConversionVetoProducer.cc
+
+Description: computes once per event the conversion veto of the electrons, stored as an edm::ValueMap<bool>
+(true if the electron passes the veto, i.e. !ConversionTools::hasMatchedConversion)
+
+Implementation:
+   - the tracks of the good conversions (ConversionTools::isGoodConversion) are gathered and sorted once,
+     each electron then looking up its GSF track and, with allowCkfMatch, its closest CTF track
+   - same result as ConversionTools::hasMatchedConversion with the same cuts, for RECO and PAT electrons
+     (the tracks of the GsfElectron base are used, as in ConversionTools, not the embedded PAT ones)
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
+
+//
+// class declaration
+//
+
+class ConversionVetoProducer : public edm::global::EDProducer<> {
+  public:
+    explicit ConversionVetoProducer(const edm::ParameterSet&);
+    ~ConversionVetoProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    typedef std::pair<edm::ProductID, size_t> TrackKey;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<edm::View<reco::GsfElectron>> elecsToken_;
+    edm::EDGetTokenT<std::vector<reco::Conversion>> convToken_;
+    edm::EDGetTokenT<reco::BeamSpot> bsToken_;
+    const bool allowCkfMatch_;
+    const double lxyMin_, probMin_;
+    const unsigned int nHitsBeforeVtxMax_;
+};
+
+//
+// constructors and destructor
+//
+ConversionVetoProducer::ConversionVetoProducer(const edm::ParameterSet& iConfig):
+  elecsToken_(consumes<edm::View<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
+  convToken_(consumes<std::vector<reco::Conversion>>(iConfig.getParameter<edm::InputTag>("conversions"))),
+  bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot"))),
+  allowCkfMatch_(iConfig.getParameter<bool>("allowCkfMatch")),
+  lxyMin_(iConfig.getParameter<double>("lxyMin")),
+  probMin_(iConfig.getParameter<double>("probMin")),
+  nHitsBeforeVtxMax_(iConfig.getParameter<unsigned int>("nHitsBeforeVtxMax"))
+{
+  produces<edm::ValueMap<bool>>();
+}
+
+
+ConversionVetoProducer::~ConversionVetoProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+ConversionVetoProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  Handle<View<reco::GsfElectron>> elecs;
+  iEvent.getByToken(elecsToken_, elecs);
+  Handle<std::vector<reco::Conversion>> conversions;
+  iEvent.getByToken(convToken_, conversions);
+  Handle<reco::BeamSpot> beamspot;
+  iEvent.getByToken(bsToken_, beamspot);
+
+  // tracks of the good conversions
+  std::vector<TrackKey> convTracks;
+  for (const reco::Conversion & conv : *conversions) {
+    if (!ConversionTools::isGoodConversion(conv, beamspot->position(), lxyMin_, probMin_, nHitsBeforeVtxMax_)) continue;
+    for (const RefToBase<reco::Track> & track : conv.tracks()) convTracks.push_back(TrackKey(track.id(), track.key()));
+  }
+  std::sort(convTracks.begin(), convTracks.end());
+
+  std::vector<bool> veto(elecs->size());
+  for (size_t i = 0; i < elecs->size(); i++) {
+    const reco::GsfElectron & el = elecs->at(i);
+    const reco::GsfTrackRef gsfTrack = el.reco::GsfElectron::gsfTrack();
+    const reco::TrackRef ctfTrack = el.reco::GsfElectron::closestCtfTrackRef();
+    bool matched = gsfTrack.isNonnull() && std::binary_search(convTracks.begin(), convTracks.end(), TrackKey(gsfTrack.id(), gsfTrack.key()));
+    if (!matched && allowCkfMatch_ && ctfTrack.isNonnull())
+      matched = std::binary_search(convTracks.begin(), convTracks.end(), TrackKey(ctfTrack.id(), ctfTrack.key()));
+    veto[i] = !matched;
+  }
+
+  std::unique_ptr<ValueMap<bool>> valueMap(new ValueMap<bool>());
+  ValueMap<bool>::Filler filler(*valueMap);
+  filler.insert(elecs, veto.begin(), veto.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+ConversionVetoProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("electrons", edm::InputTag("ecalDrivenGsfElectrons"));
+  desc.add<edm::InputTag>("conversions", edm::InputTag("particleFlowEGamma"));
+  desc.add<edm::InputTag>("beamspot", edm::InputTag("offlineBeamSpot"));
+  // defaults of ConversionTools::hasMatchedConversion
+  desc.add<bool>("allowCkfMatch", true);
+  desc.add<double>("lxyMin", 2.0);
+  desc.add<double>("probMin", 1e-6);
+  desc.add<unsigned int>("nHitsBeforeVtxMax", 0);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(ConversionVetoProducer);
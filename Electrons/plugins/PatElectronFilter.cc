@@ -8,7 +8,8 @@
 Description: adds a vector of pat electrons
 
 Implementation:
-- electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
+- electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf,
+  read from the bits of PatElectronIDProducer (which also reads the conversion veto)
    /!\ no ID is implemented for forward electrons as:
    - PFClusterProducer does not run on miniAOD
    - jurassic isolation needs tracks
@@ -36,7 +37,8 @@ Implementation:
 #include "DataFormats/Common/interface/Handle.h"
 
 #include "DataFormats/PatCandidates/interface/Electron.h"
-#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
 
 #include <vector>
 
@@ -56,20 +58,14 @@ class PatElectronFilter : public edm::stream::EDProducer<> {
         virtual void produce(edm::Event&, const edm::EventSetup&) override;
         virtual void endStream() override;
 
-        bool isLooseElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-        bool isMediumElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-        bool isTightElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot); 
-
         //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
         //virtual void endRun(edm::Run const&, edm::EventSetup const&) override;
         //virtual void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
         //virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
 
         // ----------member data ---------------------------
-        edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
         edm::EDGetTokenT<std::vector<pat::Electron>> elecsToken_;
-        edm::EDGetTokenT<reco::BeamSpot> bsToken_;
-        edm::EDGetTokenT<std::vector<reco::Conversion>> convToken_;
+        edm::EDGetTokenT<edm::ValueMap<int>> elecIDToken_;
 };
 
 //
@@ -86,8 +82,7 @@ class PatElectronFilter : public edm::stream::EDProducer<> {
 //
 PatElectronFilter::PatElectronFilter(const edm::ParameterSet& iConfig):
     elecsToken_(consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-    bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot"))),
-    convToken_(consumes<std::vector<reco::Conversion>>(iConfig.getParameter<edm::InputTag>("conversions")))  
+    elecIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("electronID")))
 {
     produces<std::vector<pat::Electron>>("LooseElectrons");
     produces<std::vector<double>>("LooseElectronRelIso");
@@ -117,13 +112,11 @@ PatElectronFilter::~PatElectronFilter()
 PatElectronFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
     using namespace edm;
+    using namespace objectid;
     Handle<std::vector<pat::Electron>> elecs;
     iEvent.getByToken(elecsToken_, elecs);
-    Handle<reco::ConversionCollection> conversions;
-    iEvent.getByToken(convToken_, conversions);
-    Handle<reco::BeamSpot> bsHandle;
-    iEvent.getByToken(bsToken_, bsHandle);
-    const reco::BeamSpot &beamspot = *bsHandle.product();  
+    Handle<ValueMap<int>> elecID;
+    iEvent.getByToken(elecIDToken_, elecID);
     std::unique_ptr<std::vector<pat::Electron>> filteredLooseElectrons;
     std::unique_ptr<std::vector<double>> filteredLooseElectronRelIso;
     std::unique_ptr<std::vector<pat::Electron>> filteredMediumElectrons;
@@ -140,21 +133,19 @@ PatElectronFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
         if (elecs->at(i).pt() < 10.) continue;
         if (fabs(elecs->at(i).eta()) > 3.) continue;
 
-        bool isLoose = isLooseElec(elecs->at(i),conversions,beamspot);    
-        bool isMedium = isMediumElec(elecs->at(i),conversions,beamspot);    
-        bool isTight = isTightElec(elecs->at(i),conversions,beamspot);    
+        const int bits = elecID->get(elecs.id(), i);
 
         double relIso = (elecs->at(i).puppiNoLeptonsChargedHadronIso() + elecs->at(i).puppiNoLeptonsNeutralHadronIso() + elecs->at(i).puppiNoLeptonsPhotonIso()) / elecs->at(i).pt();
 
-        if (!isLoose) continue;
+        if (!pass(bits, ELE_LOOSE)) continue;
         looseVec.push_back(elecs->at(i));
         looseIsoVec.push_back(relIso);
 
-        if (!isMedium) continue;
+        if (!pass(bits, ELE_MEDIUM)) continue;
         mediumVec.push_back(elecs->at(i));
         mediumIsoVec.push_back(relIso);
 
-        if (!isTight) continue;
+        if (!pass(bits, ELE_TIGHT)) continue;
         tightVec.push_back(elecs->at(i));
         tightIsoVec.push_back(relIso);
 
@@ -188,63 +179,6 @@ void
 PatElectronFilter::endStream() {
 }
 
-// ------------ method check that an e passes loose ID ----------------------------------
-    bool
-PatElectronFilter::isLooseElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-    if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-    if (patEl.full5x5_sigmaIetaIeta() > 0.02992) return false;
-    if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.004119) return false;
-    if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.05176) return false;
-    if (patEl.hcalOverEcal() > 6.741) return false;
-    if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 2.5) return false;
-    double Ooemoop = 999.;
-    if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-    else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-    else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-    if (Ooemoop > 73.76) return false;
-    if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-    return true;
-}
-
-// ------------ method check that an e passes medium ID ----------------------------------
-    bool
-PatElectronFilter::isMediumElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-    if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-    if (patEl.full5x5_sigmaIetaIeta() > 0.01609) return false;
-    if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.001766) return false;
-    if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.03130) return false;
-    if (patEl.hcalOverEcal() > 7.371) return false;
-    if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 1.325) return false;
-    double Ooemoop = 999.;
-    if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-    else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-    else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-    if (Ooemoop > 22.6) return false;
-    if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-    return true;
-}
-
-// ------------ method check that an e passes tight ID ----------------------------------
-    bool
-PatElectronFilter::isTightElec(const pat::Electron & patEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot) 
-{
-    if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return false;
-    if (patEl.full5x5_sigmaIetaIeta() > 0.01614) return false;
-    if (fabs(patEl.deltaEtaSuperClusterTrackAtVtx()) > 0.001322) return false;
-    if (fabs(patEl.deltaPhiSuperClusterTrackAtVtx()) > 0.06129) return false;
-    if (patEl.hcalOverEcal() > 4.492) return false;
-    if (patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt() > 1.255) return false;
-    double Ooemoop = 999.;
-    if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
-    else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
-    else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
-    if (Ooemoop > 18.26) return false;
-    if (ConversionTools::hasMatchedConversion(patEl, conversions, beamspot.position())) return false;
-    return true;
-}
-
 // ------------ method called when starting to processes a run  ------------
 /*
    void
@@ -0,0 +1,142 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Electrons
+// Class:      PatElectronIDProducer
+//
+/**\class PatElectronIDProducer PatElectronIDProducer.cc PhaseTwoAnalysis/Electrons/plugins/PatElectronIDProducer.cc
+
+Description: evaluates once per event all the working points of the electron ID of the PAT electrons, stored as
+an edm::ValueMap<int> of the objectid::ElectronBits (see PhaseTwoAnalysis/Common/interface/ObjectIDBits.h)
+
+Implementation:
+   - electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
+   - the conversion veto is read from the ValueMap of ConversionVetoProducer
+   /!\ no ID is implemented for forward electrons as:
+   - PFClusterProducer does not run on miniAOD
+   - jurassic isolation needs tracks
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <cmath>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+
+//
+// class declaration
+//
+
+class PatElectronIDProducer : public edm::global::EDProducer<> {
+  public:
+    explicit PatElectronIDProducer(const edm::ParameterSet&);
+    ~PatElectronIDProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    int idBits(const pat::Electron & patEl, bool passConvVeto) const;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<std::vector<pat::Electron>> elecsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> convVetoToken_;
+};
+
+//
+// constructors and destructor
+//
+PatElectronIDProducer::PatElectronIDProducer(const edm::ParameterSet& iConfig):
+  elecsToken_(consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
+  convVetoToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("conversionVeto")))
+{
+  produces<edm::ValueMap<int>>();
+}
+
+
+PatElectronIDProducer::~PatElectronIDProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+PatElectronIDProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  Handle<std::vector<pat::Electron>> elecs;
+  iEvent.getByToken(elecsToken_, elecs);
+  Handle<ValueMap<bool>> conversionVeto;
+  iEvent.getByToken(convVetoToken_, conversionVeto);
+
+  std::vector<int> bits(elecs->size(), 0);
+  for (size_t i = 0; i < elecs->size(); i++)
+    bits[i] = idBits(elecs->at(i), conversionVeto->get(elecs.id(), i));
+
+  std::unique_ptr<ValueMap<int>> valueMap(new ValueMap<int>());
+  ValueMap<int>::Filler filler(*valueMap);
+  filler.insert(elecs, bits.begin(), bits.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ loose, medium and tight elec ID ----------------------------------
+int
+PatElectronIDProducer::idBits(const pat::Electron & patEl, bool passConvVeto) const
+{
+  using namespace objectid;
+
+  if (fabs(patEl.superCluster()->eta()) > 1.479 && fabs(patEl.superCluster()->eta()) < 1.556) return 0;
+  if (!passConvVeto) return 0;
+  double Ooemoop = 999.;
+  if (patEl.ecalEnergy() == 0) Ooemoop = 0.;
+  else if (!std::isfinite(patEl.ecalEnergy())) Ooemoop = 998.;
+  else Ooemoop = fabs(1./patEl.ecalEnergy() - patEl.eSuperClusterOverP()/patEl.ecalEnergy());
+  const double sieie = patEl.full5x5_sigmaIetaIeta();
+  const double dEta = fabs(patEl.deltaEtaSuperClusterTrackAtVtx());
+  const double dPhi = fabs(patEl.deltaPhiSuperClusterTrackAtVtx());
+  const double hOverE = patEl.hcalOverEcal();
+  const double chIso = patEl.pfIsolationVariables().sumChargedHadronPt / patEl.pt();
+
+  // a working point fails on the first cut exceeded
+  int bits = 0;
+  if (!(sieie > 0.02992 || dEta > 0.004119 || dPhi > 0.05176 || hOverE > 6.741 || chIso > 2.5 || Ooemoop > 73.76)) bits |= ELE_LOOSE;
+  if (!(sieie > 0.01609 || dEta > 0.001766 || dPhi > 0.03130 || hOverE > 7.371 || chIso > 1.325 || Ooemoop > 22.6)) bits |= ELE_MEDIUM;
+  if (!(sieie > 0.01614 || dEta > 0.001322 || dPhi > 0.06129 || hOverE > 4.492 || chIso > 1.255 || Ooemoop > 18.26)) bits |= ELE_TIGHT;
+  return bits;
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+PatElectronIDProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("electrons", edm::InputTag("slimmedElectrons"));
+  desc.add<edm::InputTag>("conversionVeto", edm::InputTag("patConversionVeto"));
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(PatElectronIDProducer);
@@ -0,0 +1,352 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Electrons
+// Class:      RecoElectronIDProducer
+//
+/**\class RecoElectronIDProducer RecoElectronIDProducer.cc PhaseTwoAnalysis/Electrons/plugins/RecoElectronIDProducer.cc
+
+Description: evaluates once per event all the working points of the electron ID of the RECO electrons, stored as
+an edm::ValueMap<int> of the objectid::ElectronBits (see PhaseTwoAnalysis/Common/interface/ObjectIDBits.h)
+
+Implementation:
+   - electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
+   - only the electrons with pT > ptMin and |eta| < etaMax (the acceptance of the analyses) are evaluated, the
+     others get no bit
+   - |etaSC| < 1.556: cut-based ID (barrel only) with the conversion veto of ConversionVetoProducer
+   - |etaSC| > 1.556: cuts on the HGCal electron BDT, evaluated by ElectronMVAForest (same scores as TMVA::Reader)
+     for all the HGCal electrons of the event at once, the forest being shared by all the streams; the BDT needs
+     the primary vertex of the VertexContext, the score is -1 if there is none
+   - the TMVA spectators (truth matching...) are only computed and printed with mvaDebug, the status 1 gen
+     electrons being then cached once per event (KinematicsSoA)
+   - stream module, as the HGCal ID tool is per-stream
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <cmath>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "RecoEgamma/Phase2InterimID/interface/HGCalIDTool.h"
+
+#include "PhaseTwoAnalysis/Electrons/interface/ElectronMVAForest.h"
+#include "PhaseTwoAnalysis/Common/interface/KinematicsSoA.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
+//
+// class declaration
+//
+
+class RecoElectronIDProducer : public edm::stream::EDProducer<> {
+  public:
+    explicit RecoElectronIDProducer(const edm::ParameterSet&);
+    ~RecoElectronIDProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    enum ElectronMatchType {UNMATCHED = 0,
+      TRUE_PROMPT_ELECTRON,
+      TRUE_ELECTRON_FROM_TAU,
+      TRUE_NON_PROMPT_ELECTRON};
+
+  private:
+    virtual void produce(edm::Event&, const edm::EventSetup&) override;
+
+    // bits of the cut-based ID (|etaSC| < 1.556) or of the BDT cuts (|etaSC| > 1.556)
+    int idBits(const reco::GsfElectron & recoEl, bool passConvVeto, double MVAVal) const;
+    int matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles);
+    void findFirstNonElectronMother(const reco::Candidate *particle, int &ancestorPID, int &ancestorStatus);
+    // fills the BDT inputs of an HGCal electron, false if the BDT is not used for this electron
+    bool mvaInputsElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, double isoEl, float * x);
+    // prints the BDT inputs, score and TMVA spectators of an electron
+    void printMVAElec(const reco::GsfElectron & recoEl, const float * x, double MVAVal, bool passConvVeto, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, int vertexSize);
+
+    // ----------member data ---------------------------
+    KinematicsSoA genElectrons_; // status 1 gen electrons of the event, for matchToTruth
+    std::unique_ptr<HGCalIDTool> hgcEmId_;
+    std::shared_ptr<const ElectronMVAForest> elecMVA_;
+    const bool mvaDebug_;
+    const double ptMin_, etaMax_; // acceptance of the ID, the other electrons get no bit
+    // BDT inputs and scores of the event, kept by the module to reuse the allocations
+    std::vector<int> mvaRow_;       // row of the BDT inputs and score, -1 if the BDT is not used
+    std::vector<float> mvaInputs_;  // one row of ElectronMVAForest inputs per HGCal electron
+    std::vector<double> mvaScore_;
+
+    edm::EDGetTokenT<edm::View<reco::GsfElectron>> elecsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> convVetoToken_;
+    edm::EDGetTokenT<edm::ValueMap<double>> trackIsoValueMapToken_;
+    edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
+    edm::EDGetTokenT<VertexContext> vtxContextToken_;
+    edm::EDGetTokenT<std::vector<reco::GenParticle>> genPartsToken_;
+};
+
+//
+// constructors and destructor
+//
+RecoElectronIDProducer::RecoElectronIDProducer(const edm::ParameterSet& iConfig):
+  mvaDebug_(iConfig.getParameter<bool>("mvaDebug")),
+  ptMin_(iConfig.getParameter<double>("ptMin")),
+  etaMax_(iConfig.getParameter<double>("etaMax")),
+  elecsToken_(consumes<edm::View<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
+  convVetoToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("conversionVeto"))),
+  trackIsoValueMapToken_(consumes<edm::ValueMap<double>>(iConfig.getParameter<edm::InputTag>("trackIsoValueMap"))),
+  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
+  vtxContextToken_(consumes<VertexContext>(iConfig.getParameter<edm::InputTag>("vertexContext")))
+{
+  // the gen particles only give the truth spectator of the BDT, printed with mvaDebug
+  if (mvaDebug_) genPartsToken_ = consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genParts"));
+
+  const edm::ParameterSet& hgcIdCfg = iConfig.getParameterSet("HGCalIDToolConfig");
+  auto cc = consumesCollector();
+  hgcEmId_.reset( new HGCalIDTool(hgcIdCfg, cc) );
+
+  elecMVA_ = ElectronMVAForest::get(iConfig.getParameter<std::string>("mvaWeights"));
+  if (!elecMVA_->isValid())
+    throw cms::Exception("Configuration") << "RecoElectronIDProducer: " << elecMVA_->error();
+  if (elecMVA_->variables().size() != 12)
+    throw cms::Exception("Configuration") << "RecoElectronIDProducer: the electron BDT has " << elecMVA_->variables().size() << " inputs instead of 12";
+
+  produces<edm::ValueMap<int>>();
+}
+
+
+RecoElectronIDProducer::~RecoElectronIDProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+  void
+RecoElectronIDProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  using namespace edm;
+
+  hgcEmId_->getEventSetup(iSetup);
+  hgcEmId_->getEvent(iEvent);
+
+  Handle<View<reco::GsfElectron>> elecs;
+  iEvent.getByToken(elecsToken_, elecs);
+  Handle<ValueMap<bool>> conversionVeto;
+  iEvent.getByToken(convVetoToken_, conversionVeto);
+  Handle<ValueMap<double>> trackIsoValueMap;
+  iEvent.getByToken(trackIsoValueMapToken_, trackIsoValueMap);
+  Handle<std::vector<reco::Vertex>> vertices;
+  iEvent.getByToken(verticesToken_, vertices);
+  Handle<VertexContext> vtxContext;
+  iEvent.getByToken(vtxContextToken_, vtxContext);
+  Handle<std::vector<reco::GenParticle>> genParts;
+  if (mvaDebug_) {
+    iEvent.getByToken(genPartsToken_, genParts);
+    if (genParts.isValid()) genElectrons_.fill(*genParts, [](const reco::GenParticle & p) { return abs(p.pdgId()) == 11 && p.status() == 1; });
+    else genElectrons_.clear();
+  }
+
+  // BDT inputs of the HGCal electrons, the BDT being then evaluated for all of them at once
+  mvaRow_.assign(elecs->size(), -1);
+  mvaInputs_.clear();
+  for (size_t i = 0; vtxContext->hasPrimaryVertex() && i < elecs->size(); i++) {
+    const reco::GsfElectron & el = elecs->at(i);
+    if (el.pt() < ptMin_ || fabs(el.eta()) > etaMax_) continue;
+    const double eljurassicIso = trackIsoValueMap->get(elecs.id(), i);
+    float x[12];
+    if (!mvaInputsElec(el, vertices->at(vtxContext->primaryVertex), eljurassicIso/el.pt(), x)) continue;
+    mvaRow_[i] = mvaInputs_.size()/12;
+    mvaInputs_.insert(mvaInputs_.end(), x, x+12);
+  }
+  mvaScore_.resize(mvaInputs_.size()/12);
+  if (!mvaScore_.empty()) elecMVA_->evaluate(mvaInputs_.data(), mvaScore_.size(), mvaScore_.data());
+
+  std::vector<int> bits(elecs->size(), 0);
+  for (size_t i = 0; i < elecs->size(); i++) {
+    if (elecs->at(i).pt() < ptMin_ || fabs(elecs->at(i).eta()) > etaMax_) continue;
+    const int row = mvaRow_[i];
+    // scores are stored as float, as they were by TMVA::Reader
+    const double elMVAVal = row < 0 ? -1. : (double)(float)mvaScore_[row];
+    const bool passConvVeto = conversionVeto->get(elecs.id(), i);
+    if (mvaDebug_ && row >= 0) printMVAElec(elecs->at(i), &mvaInputs_[12*row], elMVAVal, passConvVeto, genParts, vertices->size());
+    bits[i] = idBits(elecs->at(i), passConvVeto, elMVAVal);
+  }
+
+  std::unique_ptr<ValueMap<int>> valueMap(new ValueMap<int>());
+  ValueMap<int>::Filler filler(*valueMap);
+  filler.insert(elecs, bits.begin(), bits.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ loose, medium and tight elec ID -----------
+int
+RecoElectronIDProducer::idBits(const reco::GsfElectron & recoEl, bool passConvVeto, double MVAVal) const {
+  using namespace objectid;
+
+  if (fabs(recoEl.superCluster()->eta()) >= 1.556)
+    return (MVAVal > -0.01 ? ELE_LOOSE : 0) | (MVAVal > 0.03 ? ELE_MEDIUM : 0) | (MVAVal > 0.1 ? ELE_TIGHT : 0);
+
+  if (fabs(recoEl.superCluster()->eta()) >= 1.479 || !passConvVeto) return 0;
+  double Ooemoop = 999.;
+  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
+  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
+  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
+  const double sieie = recoEl.full5x5_sigmaIetaIeta();
+  const double dEta = fabs(recoEl.deltaEtaSuperClusterTrackAtVtx());
+  const double dPhi = fabs(recoEl.deltaPhiSuperClusterTrackAtVtx());
+  const double hOverE = recoEl.hcalOverEcal();
+  const double chIso = recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt();
+
+  int bits = 0;
+  if (sieie < 0.02992 && dEta < 0.004119 && dPhi < 0.05176 && hOverE < 6.741 && Ooemoop < 73.76 && chIso < 2.5) bits |= ELE_LOOSE;
+  if (sieie < 0.01609 && dEta < 0.001766 && dPhi < 0.03130 && hOverE < 7.371 && Ooemoop < 22.6 && chIso < 1.325) bits |= ELE_MEDIUM;
+  if (sieie < 0.01614 && dEta < 0.001322 && dPhi < 0.06129 && hOverE < 4.492 && Ooemoop < 18.26 && chIso < 1.255) bits |= ELE_TIGHT;
+  return bits;
+}
+
+// ------------ match reco elec to gen elec ------------
+int 
+RecoElectronIDProducer::matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles) {
+  // 
+  // Geometric matching method (advised by Josh Bendavid)
+  //
+
+  // Find the closest status 1 gen electron to the reco electron, within deltaR 0.1
+  // (genElectrons_ caches the status 1 gen electrons of the event)
+  const int iClosest = genElectrons_.nearest(recoEl.eta(), recoEl.phi(), 0.1);
+  // If there is none, no match found.
+  if (iClosest < 0) {
+    return UNMATCHED;
+  }
+  const reco::Candidate *closestElectron = &(*genParticles)[iClosest];
+
+  // 
+  int ancestorPID = -999; 
+  int ancestorStatus = -999;
+  findFirstNonElectronMother(closestElectron, ancestorPID, ancestorStatus);
+
+  if(ancestorPID == -999 && ancestorStatus == -999){
+    // No non-electron parent??? This should never happen.
+    // Complain.
+    printf("SimpleElectronNtupler: ERROR! Electron does not apper to have a non-electron parent\n");
+    return UNMATCHED;
+  }
+
+  if(abs(ancestorPID) > 50 && ancestorStatus == 2)
+    return TRUE_NON_PROMPT_ELECTRON;
+
+  if(abs(ancestorPID) == 15 && ancestorStatus == 2)
+    return TRUE_ELECTRON_FROM_TAU;
+
+  // What remains is true prompt electrons
+  return TRUE_PROMPT_ELECTRON;
+}
+void 
+RecoElectronIDProducer::findFirstNonElectronMother(const reco::Candidate *particle,
+    int &ancestorPID, int &ancestorStatus) {
+
+  if(particle == 0){
+    printf("SimpleElectronNtupler: ERROR! null candidate pointer, this should never happen\n");
+    return;
+  }
+
+  // Is this the first non-electron parent? If yes, return, otherwise
+  // go deeper into recursion
+  if(abs(particle->pdgId()) == 11){
+    findFirstNonElectronMother(particle->mother(0), ancestorPID, ancestorStatus);
+  }else{
+    ancestorPID = particle->pdgId();
+    ancestorStatus = particle->status();
+  }
+
+  return;
+}
+
+// ------------ inputs of the tight HGCal electron ID --------------
+bool 
+RecoElectronIDProducer::mvaInputsElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, double isoEl, float * x) {
+
+  if (fabs(recoEl.superCluster()->eta()) < 1.556) return false;
+
+  bool isHGCal = hgcEmId_->setElectronPtr(&recoEl);
+  if (!isHGCal) return false;
+
+  // in the order of the variables of the weights file
+  x[0] = std::abs(hgcEmId_->getClusterStartPosition().z());
+  x[1] = hgcEmId_->getClusterLengthCompatibility();
+  x[2] = hgcEmId_->getClusterSigmaEtaEta();
+  x[3] = recoEl.trackPositionAtCalo().eta() - hgcEmId_->getClusterStartPosition().eta();
+  x[4] = reco::deltaPhi(recoEl.trackPositionAtCalo().phi(), hgcEmId_->getClusterStartPosition().phi());
+  x[5] = hgcEmId_->getClusterHadronFraction();
+  x[6] = recoEl.trackMomentumOut().Unit().Dot(hgcEmId_->getClusterShowerAxis().Unit());
+  x[7] = (float)isoEl;
+  if (recoEl.ecalEnergy() == 0) x[8] = 1e30;
+  else if (!std::isfinite(recoEl.ecalEnergy())) x[8] = 1e30;
+  else x[8] = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
+  x[9] = recoEl.gsfTrack()->dxy(recoVtx.position());
+  x[10] = recoEl.gsfTrack()->dz(recoVtx.position());
+  x[11] = (float)recoEl.gsfTrack()->hitPattern().numberOfHits(reco::HitPattern::MISSING_INNER_HITS);
+
+  return true;
+}
+
+// ------------ debug printout of the tight HGCal electron ID --------------
+void 
+RecoElectronIDProducer::printMVAElec(const reco::GsfElectron & recoEl, const float * x, double MVAVal, bool passConvVeto, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, int vertexSize) {
+
+  edm::LogInfo log("ElectronMVA");
+  for (size_t v = 0; v < elecMVA_->variables().size(); v++) log << elecMVA_->variables()[v] << " = " << x[v] << ", ";
+  // spectators of the training
+  log << "pt = " << recoEl.pt()
+      << ", nPV = " << vertexSize
+      << ", etaSC = " << recoEl.superCluster()->eta()
+      << ", phiSC = " << recoEl.superCluster()->phi()
+      << ", isTrue = " << (genParticles.isValid() ? matchToTruth(recoEl, genParticles) : -1)
+      << ", passConversionVeto = " << passConvVeto
+      << ": BDT = " << MVAVal;
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+RecoElectronIDProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("electrons", edm::InputTag("ecalDrivenGsfElectrons"));
+  desc.add<edm::InputTag>("conversionVeto", edm::InputTag("conversionVeto"));
+  desc.add<edm::InputTag>("trackIsoValueMap", edm::InputTag("electronTrackIsolationLcone"));
+  desc.add<edm::InputTag>("vertices", edm::InputTag("offlinePrimaryVertices"));
+  desc.add<edm::InputTag>("vertexContext", edm::InputTag("vertexContext"));
+  // TMVA weights XML or binary forest file (see ElectronMVAForest)
+  desc.add<std::string>("mvaWeights", "TMVAClassification_BDT.weights.xml");
+  desc.add<bool>("mvaDebug", false);
+  desc.add<double>("ptMin", 10.);
+  desc.add<double>("etaMax", 3.);
+  desc.add<edm::InputTag>("genParts", edm::InputTag("genParticles"));
+  // validated by HGCalIDTool
+  edm::ParameterSetDescription hgcIdDesc;
+  hgcIdDesc.setAllowAnything();
+  desc.add<edm::ParameterSetDescription>("HGCalIDToolConfig", hgcIdDesc);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(RecoElectronIDProducer);
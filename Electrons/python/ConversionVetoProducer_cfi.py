@@ -0,0 +1,17 @@
+import FWCore.ParameterSet.Config as cms
+
+# conversion veto of the electrons, computed once per event (ValueMap<bool>, true if the electron passes)
+conversionVeto = cms.EDProducer('ConversionVetoProducer',
+        electrons         = cms.InputTag("ecalDrivenGsfElectrons"),
+        conversions       = cms.InputTag("particleFlowEGamma"),
+        beamspot          = cms.InputTag("offlineBeamSpot"),
+        allowCkfMatch     = cms.bool(True),
+        lxyMin            = cms.double(2.0),
+        probMin           = cms.double(1e-6),
+        nHitsBeforeVtxMax = cms.uint32(0),
+)
+
+patConversionVeto = conversionVeto.clone(
+        electrons         = cms.InputTag("slimmedElectrons"),
+        conversions       = cms.InputTag("reducedEgamma", "reducedConversions", "PAT"),
+)
@@ -0,0 +1,28 @@
+import FWCore.ParameterSet.Config as cms
+
+# all the working points of the electron ID, computed once per event (ValueMap<int> of objectid::ElectronBits)
+electronID = cms.EDProducer('RecoElectronIDProducer',
+        electrons        = cms.InputTag("ecalDrivenGsfElectrons"),
+        conversionVeto   = cms.InputTag("conversionVeto"),
+        trackIsoValueMap = cms.InputTag("electronTrackIsolationLcone"),
+        vertices         = cms.InputTag("offlinePrimaryVertices"),
+        vertexContext    = cms.InputTag("vertexContext"),
+        mvaWeights       = cms.string("TMVAClassification_BDT.weights.xml"),
+        mvaDebug         = cms.bool(False),
+        ptMin            = cms.double(10.),
+        etaMax           = cms.double(3.),
+        genParts         = cms.InputTag("genParticles"),
+        HGCalIDToolConfig = cms.PSet(
+            HGCBHInput = cms.InputTag("HGCalRecHit","HGCHEBRecHits"),
+            HGCEEInput = cms.InputTag("HGCalRecHit","HGCEERecHits"),
+            HGCFHInput = cms.InputTag("HGCalRecHit","HGCHEFRecHits"),
+            HGCPFRecHits = cms.InputTag("particleFlowRecHitHGC::ElectronFilter"),
+            withPileup = cms.bool(True),
+            debug = cms.bool(False),
+        ),
+)
+
+patElectronID = cms.EDProducer('PatElectronIDProducer',
+        electrons        = cms.InputTag("slimmedElectrons"),
+        conversionVeto   = cms.InputTag("patConversionVeto"),
+)
@@ -0,0 +1,406 @@
+#include "PhaseTwoAnalysis/Electrons/interface/ElectronMVAForest.h"
+
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <mutex>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+  // minimal reader of the tags of the TMVA weights files (no entities, no CDATA)
+  struct XmlTag {
+    std::string name;
+    std::map<std::string, std::string> attributes;
+    bool closing, selfClosing;
+    std::string text;       // text following the tag, up to the next one
+
+    std::string attribute(const std::string &key) const
+    {
+      std::map<std::string, std::string>::const_iterator it = attributes.find(key);
+      return it == attributes.end() ? std::string() : it->second;
+    }
+  };
+
+  bool
+    nextTag(const std::string &text, size_t &pos, XmlTag &tag)
+    {
+      while (true) {
+        pos = text.find('<', pos);
+        if (pos == std::string::npos) return false;
+        if (text.compare(pos, 4, "<!--") == 0) {
+          pos = text.find("-->", pos);
+          if (pos == std::string::npos) return false;
+          continue;
+        }
+        if (text.compare(pos, 2, "<?") == 0) {
+          pos = text.find("?>", pos);
+          if (pos == std::string::npos) return false;
+          continue;
+        }
+        break;
+      }
+      const size_t end = text.find('>', pos);
+      if (end == std::string::npos) return false;
+
+      size_t i = pos + 1;
+      tag.closing = text[i] == '/';
+      if (tag.closing) i++;
+      tag.selfClosing = text[end-1] == '/';
+      const size_t last = tag.selfClosing ? end-1 : end;
+      size_t j = i;
+      while (j < last && !std::isspace((unsigned char)text[j])) j++;
+      tag.name = text.substr(i, j-i);
+      tag.attributes.clear();
+      while (j < last) {
+        while (j < last && std::isspace((unsigned char)text[j])) j++;
+        const size_t eq = text.find('=', j);
+        if (eq == std::string::npos || eq >= last) break;
+        const size_t q1 = text.find('"', eq);
+        const size_t q2 = text.find('"', q1+1);
+        if (q1 == std::string::npos || q2 == std::string::npos || q2 >= last) return false;
+        size_t k = eq;
+        while (k > j && std::isspace((unsigned char)text[k-1])) k--;
+        tag.attributes[text.substr(j, k-j)] = text.substr(q1+1, q2-q1-1);
+        j = q2 + 1;
+      }
+
+      pos = end + 1;
+      const size_t next = text.find('<', pos);
+      tag.text = text.substr(pos, (next == std::string::npos ? text.size() : next) - pos);
+      return true;
+    }
+
+  std::string
+    trim(const std::string &s)
+    {
+      size_t b = 0, e = s.size();
+      while (b < e && std::isspace((unsigned char)s[b])) b++;
+      while (e > b && std::isspace((unsigned char)s[e-1])) e--;
+      return s.substr(b, e-b);
+    }
+
+  const uint32_t NO_CHILD = 0xFFFFFFFFu;
+
+  const char MAGIC[8] = {'E', 'M', 'V', 'A', 'F', 'O', 'R', '1'};
+
+  struct Header {
+    char magic[8];
+    uint32_t nVariables, nTrees, nNodes, namesSize;
+    uint64_t checksum;
+  };
+
+  uint64_t
+    fnv1a(const char *bytes, size_t size)
+    {
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+}
+
+ElectronMVAForest::ElectronMVAForest(const std::string &fileName):
+  nodes_(0), roots_(0), boostWeights_(0), nTrees_(0), nNodes_(0), norm_(0.), map_(0), mapSize_(0)
+{
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error_ = "cannot read " + fileName;
+    return;
+  }
+  struct stat st;
+  char magic[sizeof(MAGIC)];
+  const bool binary = fstat(fd, &st) == 0 && pread(fd, magic, sizeof(magic), 0) == (ssize_t)sizeof(magic)
+    && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  bool ok;
+  if (binary) {
+    ok = map(fd, st.st_size);
+    close(fd);
+  } else {
+    close(fd);
+    std::ifstream in(fileName.c_str());
+    std::stringstream text;
+    text << in.rdbuf();
+    ok = parse(text.str());
+    if (ok) {
+      nodes_ = nodeStore_.data();
+      roots_ = rootStore_.data();
+      boostWeights_ = weightStore_.data();
+      nTrees_ = rootStore_.size();
+      nNodes_ = nodeStore_.size();
+    }
+  }
+  if (!ok) {
+    variables_.clear();
+    nodeStore_.clear();
+    rootStore_.clear();
+    weightStore_.clear();
+    nodes_ = 0;
+    roots_ = 0;
+    boostWeights_ = 0;
+    nTrees_ = nNodes_ = 0;
+    if (map_) munmap(map_, mapSize_);
+    map_ = 0;
+    if (error_.empty()) error_ = "unexpected content";
+    error_ = fileName + ": " + error_;
+    return;
+  }
+
+  // same summation order as TMVA::MethodBDT
+  for (size_t t = 0; t < nTrees_; t++) norm_ += boostWeights_[t];
+}
+
+ElectronMVAForest::~ElectronMVAForest()
+{
+  if (map_) munmap(map_, mapSize_);
+}
+
+  bool
+ElectronMVAForest::parse(const std::string &text)
+{
+  std::map<std::string, std::string> options;
+  // node indices of the tree being read, and the cut types of the internal ones
+  std::vector<uint32_t> stack;
+  std::vector<bool> inverted;
+  bool inTree = false;
+
+  size_t pos = 0;
+  XmlTag tag;
+  while (nextTag(text, pos, tag)) {
+    if (tag.name == "Option" && !tag.closing) {
+      options[tag.attribute("name")] = trim(tag.text);
+    }
+    else if (tag.name == "Variable" && !tag.closing) {
+      if (std::atoi(tag.attribute("VarIndex").c_str()) != (int)variables_.size()) {
+        error_ = "variables are not in VarIndex order";
+        return false;
+      }
+      variables_.push_back(tag.attribute("Expression"));
+    }
+    else if (tag.name == "Weights" && !tag.closing) {
+      if (options["BoostType"] == "Grad") {
+        error_ = "gradient boosting is not supported";
+        return false;
+      }
+      if (options["VarTransform"] != "None" || options["DoPreselection"] != "False") {
+        error_ = "input transformations and preselections are not supported";
+        return false;
+      }
+    }
+    else if (tag.name == "BinaryTree" && !tag.closing) {
+      weightStore_.push_back(std::strtod(tag.attribute("boostWeight").c_str(), 0));
+      rootStore_.push_back(nodeStore_.size());
+      stack.clear();
+      inTree = true;
+    }
+    else if (tag.name == "BinaryTree" && tag.closing) {
+      if (!inTree || !stack.empty()) return false;
+      for (size_t i = rootStore_.back(); i < nodeStore_.size(); i++) {
+        if (nodeStore_[i].var >= 0 && (nodeStore_[i].child[0] == NO_CHILD || nodeStore_[i].child[1] == NO_CHILD)) {
+          error_ = "incomplete tree";
+          return false;
+        }
+      }
+      inTree = false;
+    }
+    else if (tag.name == "Node" && !tag.closing) {
+      if (!inTree) return false;
+      if (std::atoi(tag.attribute("NCoef").c_str()) != 0) {
+        error_ = "Fisher cuts are not supported";
+        return false;
+      }
+      Node node;
+      const int nType = std::atoi(tag.attribute("nType").c_str());
+      // the float parsing of TMVA (Float_t cut and purity read from a stream)
+      if (nType == 0) {
+        node.var = std::atoi(tag.attribute("IVar").c_str());
+        node.cut = std::strtof(tag.attribute("Cut").c_str(), 0);
+        if (node.var < 0 || node.var >= (int)variables_.size()) {
+          error_ = "unknown input variable in a node";
+          return false;
+        }
+      } else {
+        node.var = -1;
+        node.cut = options["UseYesNoLeaf"] == "False" ? std::strtof(tag.attribute("purity").c_str(), 0) : (float)nType;
+      }
+      node.unused = 0;
+      node.child[0] = node.child[1] = NO_CHILD;
+
+      const uint32_t index = nodeStore_.size();
+      if (!stack.empty()) {
+        // x >= cut goes right, or left if the parent has cType = 0
+        const bool right = tag.attribute("pos") == "r";
+        Node &parent = nodeStore_[stack.back()];
+        if (parent.var < 0) {
+          error_ = "leaf with children";
+          return false;
+        }
+        parent.child[right != inverted[stack.back()] ? 1 : 0] = index;
+      }
+      else if (index != rootStore_.back()) {
+        error_ = "several roots in a tree";
+        return false;
+      }
+      nodeStore_.push_back(node);
+      inverted.push_back(std::atoi(tag.attribute("cType").c_str()) == 0);
+      if (!tag.selfClosing) stack.push_back(index);
+    }
+    else if (tag.name == "Node" && tag.closing) {
+      if (stack.empty()) return false;
+      stack.pop_back();
+    }
+  }
+
+  if (rootStore_.empty() || inTree) {
+    error_ = "no complete tree";
+    return false;
+  }
+  return true;
+}
+
+  bool
+ElectronMVAForest::map(int fd, size_t size)
+{
+  if (size < sizeof(Header)) return false;
+  void *map = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    error_ = "cannot map the file";
+    return false;
+  }
+  map_ = map;
+  mapSize_ = size;
+
+  const char *bytes = static_cast<const char*>(map_);
+  Header header;
+  std::memcpy(&header, bytes, sizeof(header));
+  const size_t weightsOffset = sizeof(Header);
+  const size_t rootsOffset = weightsOffset + header.nTrees*sizeof(double);
+  const size_t nodesOffset = rootsOffset + header.nTrees*sizeof(uint32_t);
+  const size_t namesOffset = nodesOffset + (size_t)header.nNodes*sizeof(Node);
+  if (namesOffset + header.namesSize != size) {
+    error_ = "truncated file";
+    return false;
+  }
+  if (fnv1a(bytes + sizeof(Header), size - sizeof(Header)) != header.checksum) {
+    error_ = "checksum mismatch";
+    return false;
+  }
+
+  boostWeights_ = reinterpret_cast<const double*>(bytes + weightsOffset);
+  roots_ = reinterpret_cast<const uint32_t*>(bytes + rootsOffset);
+  nodes_ = reinterpret_cast<const Node*>(bytes + nodesOffset);
+  const char *name = bytes + namesOffset;
+  const char *namesEnd = name + header.namesSize;
+  while (name < namesEnd && variables_.size() < header.nVariables) {
+    const size_t length = strnlen(name, namesEnd - name);
+    variables_.push_back(std::string(name, length));
+    name += length + 1;
+  }
+  if (variables_.size() != header.nVariables) {
+    error_ = "bad variable names";
+    return false;
+  }
+
+  // the node walk trusts the child and variable indices
+  for (size_t t = 0; t < header.nTrees; t++)
+    if (roots_[t] >= header.nNodes) return false;
+  for (size_t i = 0; i < header.nNodes; i++) {
+    if (nodes_[i].var < 0) continue;
+    if (nodes_[i].var >= (int)header.nVariables || nodes_[i].child[0] >= header.nNodes || nodes_[i].child[1] >= header.nNodes) {
+      error_ = "bad node";
+      return false;
+    }
+  }
+  nTrees_ = header.nTrees;
+  nNodes_ = header.nNodes;
+  return true;
+}
+
+  bool
+ElectronMVAForest::write(const std::string &fileName) const
+{
+  if (!isValid()) return false;
+
+  std::string payload;
+  payload.append(reinterpret_cast<const char*>(boostWeights_), nTrees_*sizeof(double));
+  payload.append(reinterpret_cast<const char*>(roots_), nTrees_*sizeof(uint32_t));
+  payload.append(reinterpret_cast<const char*>(nodes_), nNodes_*sizeof(Node));
+  const size_t namesOffset = payload.size();
+  for (size_t v = 0; v < variables_.size(); v++) payload.append(variables_[v].c_str(), variables_[v].size() + 1);
+
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.nVariables = variables_.size();
+  header.nTrees = nTrees_;
+  header.nNodes = nNodes_;
+  header.namesSize = payload.size() - namesOffset;
+  header.checksum = fnv1a(payload.data(), payload.size());
+
+  FILE *f = std::fopen(fileName.c_str(), "wb");
+  if (!f) return false;
+  bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 && std::fwrite(payload.data(), 1, payload.size(), f) == payload.size();
+  return std::fclose(f) == 0 && ok;
+}
+
+  std::shared_ptr<const ElectronMVAForest>
+ElectronMVAForest::get(const std::string &fileName)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const ElectronMVAForest> > forests;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const ElectronMVAForest> forest = forests[fileName].lock();
+  if (!forest) {
+    forest = std::make_shared<const ElectronMVAForest>(fileName);
+    forests[fileName] = forest;
+  }
+  return forest;
+}
+
+  double
+ElectronMVAForest::evaluate(const float *x) const
+{
+  double score;
+  evaluate(x, 1, &score);
+  return score;
+}
+
+  void
+ElectronMVAForest::evaluate(const float *x, size_t n, double *scores) const
+{
+  const size_t nVars = variables_.size();
+  for (size_t e = 0; e < n; e++) scores[e] = 0.;
+
+  // trees in the outer loop, each one staying in cache for the whole batch
+  const Node *nodes = nodes_;
+  for (size_t t = 0; t < nTrees_; t++) {
+    const double weight = boostWeights_[t];
+    const Node *root = nodes + roots_[t];
+    for (size_t e = 0; e < n; e++) {
+      const float *in = x + e*nVars;
+      const Node *node = root;
+      while (node->var >= 0) node = nodes + node->child[in[node->var] >= node->cut];
+      scores[e] += weight * node->cut;
+    }
+  }
+
+  for (size_t e = 0; e < n; e++) {
+    const float *in = x + e*nVars;
+    bool isNaN = false;
+    for (size_t v = 0; v < nVars; v++) isNaN |= std::isnan(in[v]);
+    if (isNaN) scores[e] = -999.;
+    else scores[e] = norm_ > std::numeric_limits<double>::epsilon() ? scores[e] / norm_ : 0.;
+  }
+}
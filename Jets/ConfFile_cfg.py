@@ -101,6 +101,17 @@ else:
                             )
         process.jetfilter.jets = "updatedPatJetsUpdatedJECAK4PFPuppi"
 
+# jets overlapping with a lepton, computed once per event on the jet collection of the filter
+process.load("PhaseTwoAnalysis.Common.OverlapRemovalProducer_cfi")
+overlapName = "patJetLeptonOverlaps"
+if (options.inputFormat.lower() == "reco"):
+    overlapName = "jetLeptonOverlaps"
+jetOverlaps = getattr(process, overlapName)
+jetOverlaps.jets = process.jetfilter.jets
+# jet ID and b-tagging working points, computed once per event on the same jets (PAT only)
+process.load("PhaseTwoAnalysis.Jets.PatJetIDProducer_cfi")
+process.patJetID.jets = process.jetfilter.jets
+
 process.out = cms.OutputModule("PoolOutputModule",
     outputCommands = cms.untracked.vstring('keep *_*_*_*',
                                            'drop patJets_slimmedJetsPuppi_*_*',
@@ -112,13 +123,13 @@ process.out = cms.OutputModule("PoolOutputModule",
 # Different modules will need to be run in each case
 if (options.inputFormat.lower() == "reco"):
     if options.updateJEC:
-        process.p = cms.Path(process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.jetfilter)
+        process.p = cms.Path(process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * jetOverlaps * process.jetfilter)
     else:
-        process.p = cms.Path(process.puSequence * process.jetfilter)
+        process.p = cms.Path(process.puSequence * jetOverlaps * process.jetfilter)
 else:
     if options.updateJEC:
-        process.p = cms.Path(process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.jetfilter)
+        process.p = cms.Path(process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * jetOverlaps * process.patJetID * process.jetfilter)
     else:
-        process.p = cms.Path(process.jetfilter)
+        process.p = cms.Path(jetOverlaps * process.patJetID * process.jetfilter)
 
 process.e = cms.EndPath(process.out)
@@ -10,6 +10,8 @@ Description: adds vectors of pat ak4 PUPPI loose PF jets
 Implementation:
 - PF jet ID comes from Run-2 https://github.com/cms-sw/cmssw/blob/CMSSW_9_1_1_patch1/PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h
 - b-tagging WPs come from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#B_tagging 
+- both are read from the bits of PatJetIDProducer
+- jets overlapping with a lepton are removed with the keep-mask of OverlapRemovalProducer (jetKeepMask)
 */
 //
 // Original Author:  Elvire Bouvier
@@ -32,12 +34,10 @@ Implementation:
 #include "FWCore/Utilities/interface/StreamID.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/ValueMap.h"
 
-#include "DataFormats/MuonReco/interface/Muon.h"
-#include "DataFormats/PatCandidates/interface/Muon.h"
-#include "DataFormats/PatCandidates/interface/Electron.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
-#include "PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
 
 #include <vector>
 
@@ -63,13 +63,9 @@ class PatJetFilter : public edm::stream::EDProducer<> {
     //virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
 
     // ----------member data ---------------------------
-    unsigned int pileup_;
-    edm::EDGetTokenT<std::vector<pat::Electron>> elecsToken_;
-    edm::EDGetTokenT<std::vector<pat::Muon>> muonsToken_;
     edm::EDGetTokenT<std::vector<pat::Jet>> jetsToken_;
-    PFJetIDSelectionFunctor jetIDLoose_;
-    double mvaThres_[3];
-    double deepThres_[3];
+    edm::EDGetTokenT<edm::ValueMap<int>> jetIDToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> jetKeepMaskToken_;
 };
 
 //
@@ -85,11 +81,9 @@ class PatJetFilter : public edm::stream::EDProducer<> {
 // constructors and destructor
 //
 PatJetFilter::PatJetFilter(const edm::ParameterSet& iConfig):
-  pileup_(iConfig.getParameter<unsigned int>("pileup")),
-  elecsToken_(consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-  muonsToken_(consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
   jetsToken_(consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets"))),
-  jetIDLoose_(PFJetIDSelectionFunctor::FIRSTDATA, PFJetIDSelectionFunctor::LOOSE) 
+  jetIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("jetID"))),
+  jetKeepMaskToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("jetKeepMask")))
 {
   produces<std::vector<pat::Jet>>("Jets");
   produces<std::vector<pat::Jet>>("LooseMVAv2Jets");
@@ -98,36 +92,6 @@ PatJetFilter::PatJetFilter(const edm::ParameterSet& iConfig):
   produces<std::vector<pat::Jet>>("LooseDeepCSVJets");
   produces<std::vector<pat::Jet>>("MediumDeepCSVJets");
   produces<std::vector<pat::Jet>>("TightDeepCSVJets");
-
-  if (pileup_ == 0) {
-     mvaThres_[0] = -0.694;
-     mvaThres_[1] = 0.128;
-     mvaThres_[2] = 0.822;
-     deepThres_[0] = 0.131;
-     deepThres_[1] = 0.432;
-     deepThres_[2] = 0.741;
-  } else if (pileup_ == 140) {
-    mvaThres_[0] = -0.654;
-    mvaThres_[1] = 0.214;
-    mvaThres_[2] = 0.864;
-    deepThres_[0] = 0.159;
-    deepThres_[1] = 0.507;
-    deepThres_[2] = 0.799;
-  } else if (pileup_ == 200) {
-    mvaThres_[0] = -0.642;
-    mvaThres_[1] = 0.236;
-    mvaThres_[2] = 0.878;
-    deepThres_[0] = 0.170;
-    deepThres_[1] = 0.527;
-    deepThres_[2] = 0.821;
-  } else {
-    mvaThres_[0] = -1.;
-    mvaThres_[1] = -1.;
-    mvaThres_[2] = -1.;
-    deepThres_[0] = 0.;
-    deepThres_[1] = 0.;
-    deepThres_[2] = 0.;
-  }
 }
 
 
@@ -149,13 +113,14 @@ PatJetFilter::~PatJetFilter()
 PatJetFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
   using namespace edm;
+  using namespace objectid;
 
-  Handle<std::vector<pat::Muon>> muons;
-  iEvent.getByToken(muonsToken_, muons);
-  Handle<std::vector<pat::Electron>> elecs;
-  iEvent.getByToken(elecsToken_, elecs);
   Handle<std::vector<pat::Jet>> jets;
   iEvent.getByToken(jetsToken_, jets);
+  Handle<ValueMap<int>> jetID;
+  iEvent.getByToken(jetIDToken_, jetID);
+  Handle<ValueMap<bool>> jetKeepMask;
+  iEvent.getByToken(jetKeepMaskToken_, jetKeepMask);
 
   std::unique_ptr<std::vector<pat::Jet>> filteredJets;
   std::unique_ptr<std::vector<pat::Jet>> filteredLooseMVAv2Jets;
@@ -176,39 +141,20 @@ PatJetFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     if (jets->at(i).pt() < 20.) continue;
     if (fabs(jets->at(i).eta()) > 5) continue;
 
-    bool overlaps = false;
-    for (size_t j = 0; j < elecs->size(); j++) {
-      if (fabs(jets->at(i).pt()-elecs->at(j).pt()) < 0.01*elecs->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(elecs->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    for (size_t j = 0; j < muons->size(); j++) {
-      if (fabs(jets->at(i).pt()-muons->at(j).pt()) < 0.01*muons->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(muons->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-
-    pat::strbitset retLoose = jetIDLoose_.getBitTemplate();
-    retLoose.set(false);
-    bool isLoose = jetIDLoose_(jets->at(i), retLoose);
-
-    if (!isLoose) continue;
+    if (!jetKeepMask->get(jets.id(), i)) continue;
+
+    const int bits = jetID->get(jets.id(), i);
+
+    if (!pass(bits, JET_LOOSE)) continue;
     Vec.push_back(jets->at(i));
 
-    double mvav2   = jets->at(i).bDiscriminator("pfCombinedMVAV2BJetTags"); 
-    if (mvav2 > mvaThres_[0]) looseMVAv2Vec.push_back(jets->at(i));
-    if (mvav2 > mvaThres_[1]) mediumMVAv2Vec.push_back(jets->at(i));
-    if (mvav2 > mvaThres_[2]) tightMVAv2Vec.push_back(jets->at(i));
+    if (pass(bits, JET_MVAV2_LOOSE)) looseMVAv2Vec.push_back(jets->at(i));
+    if (pass(bits, JET_MVAV2_MEDIUM)) mediumMVAv2Vec.push_back(jets->at(i));
+    if (pass(bits, JET_MVAV2_TIGHT)) tightMVAv2Vec.push_back(jets->at(i));
 
-    double deepcsv = jets->at(i).bDiscriminator("pfDeepCSVJetTags:probb") +
-      jets->at(i).bDiscriminator("pfDeepCSVJetTags:probbb");
-    if (deepcsv > deepThres_[0]) looseDeepCSVVec.push_back(jets->at(i));
-    if (deepcsv > deepThres_[1]) mediumDeepCSVVec.push_back(jets->at(i));
-    if (deepcsv > deepThres_[2]) tightDeepCSVVec.push_back(jets->at(i));
+    if (pass(bits, JET_DEEPCSV_LOOSE)) looseDeepCSVVec.push_back(jets->at(i));
+    if (pass(bits, JET_DEEPCSV_MEDIUM)) mediumDeepCSVVec.push_back(jets->at(i));
+    if (pass(bits, JET_DEEPCSV_TIGHT)) tightDeepCSVVec.push_back(jets->at(i));
 
   }
 
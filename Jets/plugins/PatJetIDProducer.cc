@@ -0,0 +1,182 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Jets
+// Class:      PatJetIDProducer
+//
+/**\class PatJetIDProducer PatJetIDProducer.cc PhaseTwoAnalysis/Jets/plugins/PatJetIDProducer.cc
+
+Description: evaluates once per event the PF jet ID and all the b-tagging working points of the PAT jets, stored as
+an edm::ValueMap<int> of the objectid::JetBits (see PhaseTwoAnalysis/Common/interface/ObjectIDBits.h)
+
+Implementation:
+   - PF jet ID comes from Run-2 https://github.com/cms-sw/cmssw/blob/CMSSW_9_1_1_patch1/PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h
+   - b-tagging WPs come from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#B_tagging,
+     for the pileup given in the configuration (0, 140 or 200, all the jets pass otherwise)
+   - the jet ID functors (which keep a cut flow) are stream caches
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h"
+
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+
+//
+// class declaration
+//
+
+namespace patJetID {
+  struct JetIDFunctors {
+    JetIDFunctors():
+      loose(PFJetIDSelectionFunctor::FIRSTDATA, PFJetIDSelectionFunctor::LOOSE),
+      tight(PFJetIDSelectionFunctor::FIRSTDATA, PFJetIDSelectionFunctor::TIGHT) {}
+    PFJetIDSelectionFunctor loose;
+    PFJetIDSelectionFunctor tight;
+  };
+}
+
+class PatJetIDProducer : public edm::global::EDProducer<edm::StreamCache<patJetID::JetIDFunctors>> {
+  public:
+    explicit PatJetIDProducer(const edm::ParameterSet&);
+    ~PatJetIDProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual std::unique_ptr<patJetID::JetIDFunctors> beginStream(edm::StreamID) const override;
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // ----------member data ---------------------------
+    unsigned int pileup_;
+    edm::EDGetTokenT<std::vector<pat::Jet>> jetsToken_;
+    double mvaThres_[3];
+    double deepThres_[3];
+};
+
+//
+// constructors and destructor
+//
+PatJetIDProducer::PatJetIDProducer(const edm::ParameterSet& iConfig):
+  pileup_(iConfig.getParameter<unsigned int>("pileup")),
+  jetsToken_(consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets")))
+{
+  produces<edm::ValueMap<int>>();
+
+  if (pileup_ == 0) {
+     mvaThres_[0] = -0.694;
+     mvaThres_[1] = 0.128;
+     mvaThres_[2] = 0.822;
+     deepThres_[0] = 0.131;
+     deepThres_[1] = 0.432;
+     deepThres_[2] = 0.741;
+  } else if (pileup_ == 140) {
+    mvaThres_[0] = -0.654;
+    mvaThres_[1] = 0.214;
+    mvaThres_[2] = 0.864;
+    deepThres_[0] = 0.159;
+    deepThres_[1] = 0.507;
+    deepThres_[2] = 0.799;
+  } else if (pileup_ == 200) {
+    mvaThres_[0] = -0.642;
+    mvaThres_[1] = 0.236;
+    mvaThres_[2] = 0.878;
+    deepThres_[0] = 0.170;
+    deepThres_[1] = 0.527;
+    deepThres_[2] = 0.821;
+  } else {
+    mvaThres_[0] = -1.;
+    mvaThres_[1] = -1.;
+    mvaThres_[2] = -1.;
+    deepThres_[0] = 0.;
+    deepThres_[1] = 0.;
+    deepThres_[2] = 0.;
+  }
+}
+
+
+PatJetIDProducer::~PatJetIDProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called once each stream before processing any runs, lumis or events  ------------
+  std::unique_ptr<patJetID::JetIDFunctors>
+PatJetIDProducer::beginStream(edm::StreamID) const
+{
+  return std::unique_ptr<patJetID::JetIDFunctors>(new patJetID::JetIDFunctors());
+}
+
+// ------------ method called to produce the data  ------------
+  void
+PatJetIDProducer::produce(edm::StreamID iID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+  using namespace objectid;
+
+  Handle<std::vector<pat::Jet>> jets;
+  iEvent.getByToken(jetsToken_, jets);
+  patJetID::JetIDFunctors & jetID = *streamCache(iID);
+
+  std::vector<int> bits(jets->size(), 0);
+  for (size_t i = 0; i < jets->size(); i++) {
+    const pat::Jet & jet = jets->at(i);
+
+    pat::strbitset retLoose = jetID.loose.getBitTemplate();
+    retLoose.set(false);
+    if (jetID.loose(jet, retLoose)) bits[i] |= JET_LOOSE;
+    pat::strbitset retTight = jetID.tight.getBitTemplate();
+    retTight.set(false);
+    if (jetID.tight(jet, retTight)) bits[i] |= JET_TIGHT;
+
+    double mvav2   = jet.bDiscriminator("pfCombinedMVAV2BJetTags"); 
+    if (mvav2 > mvaThres_[0]) bits[i] |= JET_MVAV2_LOOSE;
+    if (mvav2 > mvaThres_[1]) bits[i] |= JET_MVAV2_MEDIUM;
+    if (mvav2 > mvaThres_[2]) bits[i] |= JET_MVAV2_TIGHT;
+
+    double deepcsv = jet.bDiscriminator("pfDeepCSVJetTags:probb") +
+      jet.bDiscriminator("pfDeepCSVJetTags:probbb");
+    if (deepcsv > deepThres_[0]) bits[i] |= JET_DEEPCSV_LOOSE;
+    if (deepcsv > deepThres_[1]) bits[i] |= JET_DEEPCSV_MEDIUM;
+    if (deepcsv > deepThres_[2]) bits[i] |= JET_DEEPCSV_TIGHT;
+  }
+
+  std::unique_ptr<ValueMap<int>> valueMap(new ValueMap<int>());
+  ValueMap<int>::Filler filler(*valueMap);
+  filler.insert(jets, bits.begin(), bits.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+PatJetIDProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<unsigned int>("pileup", 200);
+  desc.add<edm::InputTag>("jets", edm::InputTag("slimmedJetsPuppi"));
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(PatJetIDProducer);
@@ -10,6 +10,7 @@ Description: adds a vector of reco ak4 PUPPI jets
 Implementation:
 - no jet ID is applied
 - b-tagging is not available 
+- jets overlapping with a lepton are removed with the keep-mask of OverlapRemovalProducer (jetKeepMask)
 */
 //
 // Original Author:  Elvire Bouvier
@@ -32,14 +33,11 @@ Implementation:
 #include "FWCore/Utilities/interface/StreamID.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/ValueMap.h"
 
-#include "DataFormats/MuonReco/interface/Muon.h"
-#include "DataFormats/PatCandidates/interface/Muon.h"
-#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include "DataFormats/JetReco/interface/PFJet.h"
 
 #include <vector>
-#include "Math/GenVector/VectorUtil.h"
 
 //
 // class declaration
@@ -63,9 +61,8 @@ class RecoJetFilter : public edm::stream::EDProducer<> {
     //virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
 
     // ----------member data ---------------------------
-    edm::EDGetTokenT<std::vector<reco::GsfElectron>> elecsToken_;
-    edm::EDGetTokenT<std::vector<reco::Muon>> muonsToken_;
     edm::EDGetTokenT<std::vector<reco::PFJet>> jetsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> jetKeepMaskToken_;
 
 };
 
@@ -82,9 +79,8 @@ class RecoJetFilter : public edm::stream::EDProducer<> {
 // constructors and destructor
 //
 RecoJetFilter::RecoJetFilter(const edm::ParameterSet& iConfig):
-  elecsToken_(consumes<std::vector<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-  muonsToken_(consumes<std::vector<reco::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
-  jetsToken_(consumes<std::vector<reco::PFJet>>(iConfig.getParameter<edm::InputTag>("jets")))
+  jetsToken_(consumes<std::vector<reco::PFJet>>(iConfig.getParameter<edm::InputTag>("jets"))),
+  jetKeepMaskToken_(consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("jetKeepMask")))
 {
   produces<std::vector<reco::PFJet>>("Jets");
 
@@ -110,12 +106,10 @@ RecoJetFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
   using namespace edm;
 
-  Handle<std::vector<reco::Muon>> muons;
-  iEvent.getByToken(muonsToken_, muons);
-  Handle<std::vector<reco::GsfElectron>> elecs;
-  iEvent.getByToken(elecsToken_, elecs);
   Handle<std::vector<reco::PFJet>> jets;
   iEvent.getByToken(jetsToken_, jets);
+  Handle<ValueMap<bool>> jetKeepMask;
+  iEvent.getByToken(jetKeepMaskToken_, jetKeepMask);
 
   std::unique_ptr<std::vector<reco::PFJet>> filteredJets;
   std::vector<reco::PFJet> Vec;
@@ -123,21 +117,7 @@ RecoJetFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     if (jets->at(i).pt() < 20.) continue;
     if (fabs(jets->at(i).eta()) > 5) continue;
 
-    bool overlaps = false;
-    for (size_t j = 0; j < elecs->size(); j++) {
-      if (fabs(jets->at(i).pt()-elecs->at(j).pt()) < 0.01*elecs->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(elecs->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    for (size_t j = 0; j < muons->size(); j++) {
-      if (fabs(jets->at(i).pt()-muons->at(j).pt()) < 0.01*muons->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(muons->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
+    if (!jetKeepMask->get(jets.id(), i)) continue;
     Vec.push_back(jets->at(i));
 
   }
@@ -0,0 +1,8 @@
+import FWCore.ParameterSet.Config as cms
+
+# PF jet ID and b-tagging working points of the PAT jets, computed once per event
+# (ValueMap<int> of objectid::JetBits)
+patJetID = cms.EDProducer('PatJetIDProducer',
+        pileup        = cms.uint32(200),
+        jets          = cms.InputTag("slimmedJetsPuppi"),
+)
@@ -63,6 +63,9 @@ if (options.inputFormat.lower() == "reco"):
     moduleName = "RecoMuonFilter"
 process.muonfilter = cms.EDProducer(moduleName)
 process.load("PhaseTwoAnalysis.Muons."+moduleName+"_cfi")
+# primary vertex and muon ID working points, computed once per event
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Muons.MuonIDProducer_cfi")
 
 process.out = cms.OutputModule("PoolOutputModule",
     outputCommands = cms.untracked.vstring('keep *_*_*_*',
@@ -76,8 +79,9 @@ if (options.inputFormat.lower() == "reco"):
                          +process.puppi
                          +process.particleFlowNoLep+process.puppiNoLep
                          +process.offlineSlimmedPrimaryVertices+process.packedPFCandidates
-                         +process.muonIsolationPUPPI+process.muonIsolationPUPPINoLep * process.muonfilter)
+                         +process.muonIsolationPUPPI+process.muonIsolationPUPPINoLep
+                         +process.vertexContext+process.muonIDStoredBend * process.muonfilter)
 else:
-    process.p = cms.Path(process.muonfilter)
+    process.p = cms.Path(process.patVertexContext * process.patMuonID * process.muonfilter)
 
 process.e = cms.EndPath(process.out)
@@ -0,0 +1,64 @@
+#ifndef _me0chambertable_h_
+#define _me0chambertable_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Muons
+// Class:       ME0ChamberTable
+// Description: flat copy of the ME0 chamber placements, for the ME0 muon ID
+//
+// The rotation and position of every ME0 chamber, and the local z of its first
+// and last layers, are copied once from the ME0Geometry (e.g. at beginRun) into
+// a contiguous table sorted by chamber id. The transformation to global
+// coordinates and the bending of a local track or segment (as
+// ME0Chamber::computeDeltaPhi: phi difference between its extrapolations to the
+// last and first layers) are then inline float arithmetic on the table, with
+// the operations of GloballyPositioned::toGlobal.
+
+#include <vector>
+#include <stdint.h>
+
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+class ME0Geometry;
+
+class ME0ChamberTable
+{
+  public:
+    struct Chamber {
+      float rot[9];         // xx, xy, xz, yx, yy, yz, zx, zy, zz
+      float pos[3];
+      double dzLow, dzHigh; // signed extrapolation distances to the first and last layers
+      bool hasBending;      // false with less than 2 layers, the bending being then 0
+    };
+
+    ME0ChamberTable() {}
+    explicit ME0ChamberTable(const ME0Geometry &me0Geom);
+
+    // chamber of an ME0 DetId (of the chamber or of one of its layers or partitions), null if unknown
+    const Chamber * chamber(DetId id) const;
+    size_t size() const { return chambers_.size(); }
+
+    static GlobalPoint toGlobal(const Chamber &chamber, float x, float y, float z = 0.f)
+    {
+      const float *r = chamber.rot;
+      return GlobalPoint(r[0]*x + r[3]*y + r[6]*z + chamber.pos[0],
+                         r[1]*x + r[4]*y + r[7]*z + chamber.pos[1],
+                         r[2]*x + r[5]*y + r[8]*z + chamber.pos[2]);
+    }
+
+    // bending of the local point (x, y, 0) with direction (dxdz, dydz, 1)
+    static float deltaPhi(const Chamber &chamber, float x, float y, float dxdz, float dydz)
+    {
+      if (!chamber.hasBending) return 0.f;
+      GlobalPoint high = toGlobal(chamber, x + chamber.dzHigh*dxdz, y + chamber.dzHigh*dydz, chamber.dzHigh);
+      GlobalPoint low = toGlobal(chamber, x + chamber.dzLow*dxdz, y + chamber.dzLow*dydz, chamber.dzLow);
+      return high.phi() - low.phi();
+    }
+
+  private:
+    std::vector<uint32_t> ids_;
+    std::vector<Chamber> chambers_;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef _me0muonmatch_h_
+#define _me0muonmatch_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/Muons
+// Class:       ME0MuonMatch
+// Description: track-segment match features of the ME0 muons, for the forward muon ID
+//
+// For each ME0 segment matched to the muon, the chamber is looked up in the
+// ME0ChamberTable and the track and segment positions are transformed to global
+// coordinates once, giving |deta|, |dphi| and the bending difference |dphiBend|
+// of the match.
+// A working point is then a threshold comparison on these features (see pass),
+// with the result of the former isME0MuonSelNew functions: the muon passes if
+// one of its segments passes the three cuts. As the loose and tight cuts are
+// tested on the same segments, all of them are kept and not only the best one
+// (usually one or two per muon).
+//
+// One object can be refilled for each muon of an event, keeping its storage.
+
+#include <vector>
+
+#include "DataFormats/MuonReco/interface/Muon.h"
+#include "PhaseTwoAnalysis/Muons/interface/ME0ChamberTable.h"
+
+class ME0MuonMatch
+{
+  public:
+    struct Segment {
+      double dEta, dPhi, dPhiBend;
+    };
+
+    ME0MuonMatch() {}
+    ME0MuonMatch(const reco::Muon &muon, const ME0ChamberTable &me0Chambers, bool storedSegmentBend = false)
+    {
+      fill(muon, me0Chambers, storedSegmentBend);
+    }
+
+    // computes the features of the ME0 segments of muon (none if it is not an ME0 muon); the bending
+    // of the segment is recomputed from its direction, or read from the segment with storedSegmentBend
+    void fill(const reco::Muon &muon, const ME0ChamberTable &me0Chambers, bool storedSegmentBend = false);
+
+    // true if one of the segments has dEta < dEtaCut, dPhi < dPhiCut and dPhiBend < dPhiBendCut
+    bool pass(double dEtaCut, double dPhiCut, double dPhiBendCut) const;
+
+    const std::vector<Segment> & segments() const { return segments_; }
+
+  private:
+    std::vector<Segment> segments_;
+};
+
+#endif
@@ -0,0 +1,185 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/Muons
+// Class:      MuonIDProducer
+//
+/**\class MuonIDProducer MuonIDProducer.cc PhaseTwoAnalysis/Muons/plugins/MuonIDProducer.cc
+
+Description: evaluates once per event all the working points of the muon ID, stored as an
+edm::ValueMap<int> of the objectid::MuonBits (see PhaseTwoAnalysis/Common/interface/ObjectIDBits.h)
+
+Implementation:
+   - muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_identification
+   - MU_LOOSE, MU_MEDIUM and MU_TIGHT are muon::isLooseMuon, isMediumMuon and isTightMuon (with the primary
+     vertex of the VertexContext, not set if there is none), for all |eta|
+   - the ME0 bits are only evaluated for |eta| > 2.4, from the ME0MuonMatch of the muon: medium is loose with
+     the track requirements, tight has tighter match cuts and the dz cut in addition; the dz cut is also
+     stored alone (MU_ME0_IPZ) for the modules which require it for the medium ME0 muons
+   - the ME0 segment bending is recomputed from the segment direction, or read from the segment with
+     me0StoredSegmentBend (muonIDStoredBend, used by RecoMuonFilter)
+   - the ME0 chamber table is a run cache, the muons can be RECO or PAT muons
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/MuonReco/interface/Muon.h"
+#include "DataFormats/MuonReco/interface/MuonSelectors.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+
+#include "Geometry/Records/interface/MuonGeometryRecord.h"
+#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
+#include "PhaseTwoAnalysis/Muons/interface/ME0ChamberTable.h"
+#include "PhaseTwoAnalysis/Muons/interface/ME0MuonMatch.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
+
+//
+// class declaration
+//
+
+class MuonIDProducer : public edm::global::EDProducer<edm::RunCache<ME0ChamberTable>> {
+  public:
+    explicit MuonIDProducer(const edm::ParameterSet&);
+    ~MuonIDProducer();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual std::shared_ptr<ME0ChamberTable> globalBeginRun(edm::Run const&, edm::EventSetup const&) const override;
+    virtual void globalEndRun(edm::Run const&, edm::EventSetup const&) const override {}
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<edm::View<reco::Muon>> muonsToken_;
+    edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
+    edm::EDGetTokenT<VertexContext> vtxContextToken_;
+    const bool me0StoredSegmentBend_;
+};
+
+//
+// constructors and destructor
+//
+MuonIDProducer::MuonIDProducer(const edm::ParameterSet& iConfig):
+  muonsToken_(consumes<edm::View<reco::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
+  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
+  vtxContextToken_(consumes<VertexContext>(iConfig.getParameter<edm::InputTag>("vertexContext"))),
+  me0StoredSegmentBend_(iConfig.getParameter<bool>("me0StoredSegmentBend"))
+{
+  produces<edm::ValueMap<int>>();
+}
+
+
+MuonIDProducer::~MuonIDProducer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called when starting to process a run, copies the ME0 chamber placements ------------
+  std::shared_ptr<ME0ChamberTable>
+MuonIDProducer::globalBeginRun(edm::Run const& iRun, edm::EventSetup const& iSetup) const
+{
+  edm::ESHandle<ME0Geometry> me0Geom;
+  iSetup.get<MuonGeometryRecord>().get(me0Geom);
+  return std::make_shared<ME0ChamberTable>(*me0Geom);
+}
+
+// ------------ method called to produce the data  ------------
+  void
+MuonIDProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+  using namespace objectid;
+
+  Handle<View<reco::Muon>> muons;
+  iEvent.getByToken(muonsToken_, muons);
+  Handle<std::vector<reco::Vertex>> vertices;
+  iEvent.getByToken(verticesToken_, vertices);
+  Handle<VertexContext> vtxContext;
+  iEvent.getByToken(vtxContextToken_, vtxContext);
+  const reco::Vertex * priVertex = (vtxContext->hasPrimaryVertex() ? &vertices->at(vtxContext->primaryVertex) : nullptr);
+
+  const ME0ChamberTable & me0Chambers = *runCache(iEvent.getRun().index());
+  ME0MuonMatch me0Match;
+  std::vector<int> bits(muons->size(), 0);
+  for (size_t i = 0; i < muons->size(); i++) {
+    const reco::Muon & muon = muons->at(i);
+
+    if (muon::isLooseMuon(muon)) bits[i] |= MU_LOOSE;
+    if (muon::isMediumMuon(muon)) bits[i] |= MU_MEDIUM;
+    if (priVertex && muon::isTightMuon(muon, *priVertex)) bits[i] |= MU_TIGHT;
+
+    if (std::abs(muon.eta()) <= 2.4) continue;
+    // ME0 match features, computed once for all the working points
+    me0Match.fill(muon, me0Chambers, me0StoredSegmentBend_);
+
+    bool ipxy = false, ipz = false, validPxlHit = false, highPurity = false;
+    if (priVertex && muon.innerTrack().isNonnull()) {
+      ipxy = std::abs(muon.muonBestTrack()->dxy(priVertex->position())) < 0.2;
+      ipz = std::abs(muon.muonBestTrack()->dz(priVertex->position())) < 0.5;
+      validPxlHit = muon.innerTrack()->hitPattern().numberOfValidPixelHits() > 0;
+      highPurity = muon.innerTrack()->quality(reco::Track::highPurity);
+    }
+
+    const double mom = muon.p();
+    double dPhiCut = std::min(std::max(1.2/mom,1.2/100),0.056);
+    double dPhiBendCut = std::min(std::max(0.2/mom,0.2/100),0.0096);
+    if (ipz) bits[i] |= MU_ME0_IPZ;
+    if (me0Match.pass(0.077, dPhiCut, dPhiBendCut)) {
+      bits[i] |= MU_ME0_LOOSE;
+      // medium - just loose with track requirements for now, this needs to be updated
+      if (ipxy && validPxlHit && highPurity) bits[i] |= MU_ME0_MEDIUM;
+    }
+
+    // tighter cuts for tight ME0
+    dPhiCut = std::min(std::max(1.2/mom,1.2/100),0.032);
+    dPhiBendCut = std::min(std::max(0.2/mom,0.2/100),0.0041);
+    if (me0Match.pass(0.048, dPhiCut, dPhiBendCut) && ipxy && ipz && validPxlHit && highPurity) bits[i] |= MU_ME0_TIGHT;
+  }
+
+  std::unique_ptr<ValueMap<int>> valueMap(new ValueMap<int>());
+  ValueMap<int>::Filler filler(*valueMap);
+  filler.insert(muons, bits.begin(), bits.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap));
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MuonIDProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("muons", edm::InputTag("muons"));
+  desc.add<edm::InputTag>("vertices", edm::InputTag("offlinePrimaryVertices"));
+  desc.add<edm::InputTag>("vertexContext", edm::InputTag("vertexContext"));
+  // bending of the ME0 segments read from the segment instead of recomputed from its direction
+  desc.add<bool>("me0StoredSegmentBend", false);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MuonIDProducer);
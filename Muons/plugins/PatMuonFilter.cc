@@ -8,7 +8,8 @@
 Description: adds a vector of pat muons
 
 Implementation:
-- muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_identification
+- muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_identification,
+  read from the bits of MuonIDProducer
 - muon iso comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_isolation
 */
 //
@@ -27,21 +28,17 @@ Implementation:
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
-#include "FWCore/Framework/interface/ESHandle.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/Utilities/interface/StreamID.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/ValueMap.h"
 
 #include "DataFormats/MuonReco/interface/Muon.h"
 #include "DataFormats/PatCandidates/interface/Muon.h"
-#include "DataFormats/MuonReco/interface/MuonSelectors.h"
-#include "DataFormats/VertexReco/interface/Vertex.h"
 
-#include "Geometry/Records/interface/MuonGeometryRecord.h"
-#include "Geometry/GEMGeometry/interface/ME0EtaPartitionSpecs.h"
-#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
 
 #include <vector>
 
@@ -61,18 +58,14 @@ class PatMuonFilter : public edm::stream::EDProducer<> {
         virtual void produce(edm::Event&, const edm::EventSetup&) override;
         virtual void endStream() override;
 
-        bool isME0MuonSel(reco::Muon muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi);
-        bool isME0MuonSelNew(reco::Muon, double, double, double);
-
-        virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
+        //virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
         //virtual void endRun(edm::Run const&, edm::EventSetup const&) override;
         //virtual void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
         //virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
 
         // ----------member data ---------------------------
-        edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
         edm::EDGetTokenT<std::vector<pat::Muon>> muonsToken_;
-        const ME0Geometry* ME0Geometry_; 
+        edm::EDGetTokenT<edm::ValueMap<int>> muonIDToken_;
 };
 
 //
@@ -88,8 +81,8 @@ class PatMuonFilter : public edm::stream::EDProducer<> {
 // constructors and destructor
 //
 PatMuonFilter::PatMuonFilter(const edm::ParameterSet& iConfig):
-    verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
-    muonsToken_(consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons")))
+    muonsToken_(consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
+    muonIDToken_(consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("muonID")))
 {
     produces<std::vector<pat::Muon>>("LooseMuons");
     produces<std::vector<double>>("LooseMuonRelIso");
@@ -100,14 +93,6 @@ PatMuonFilter::PatMuonFilter(const edm::ParameterSet& iConfig):
 
 }
 
-void
-PatMuonFilter::beginRun(edm::Run const& iRun, edm::EventSetup const& iSetup)
-{
-  edm::ESHandle<ME0Geometry> hGeom;
-  iSetup.get<MuonGeometryRecord>().get(hGeom);
-  ME0Geometry_ =( &*hGeom);
-}
-    
 PatMuonFilter::~PatMuonFilter()
 {
 
@@ -126,18 +111,12 @@ PatMuonFilter::~PatMuonFilter()
 PatMuonFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
     using namespace edm;
-    Handle<std::vector<reco::Vertex>> vertices;
-    iEvent.getByToken(verticesToken_, vertices);
-    // Vertices
-    int prVtx = -1;
-    for (size_t i = 0; i < vertices->size(); i++) {
-        if (vertices->at(i).isFake()) continue;
-        if (vertices->at(i).ndof() <= 4) continue;
-        if (prVtx < 0) prVtx = i;
-    }
+    using namespace objectid;
 
     Handle<std::vector<pat::Muon>> muons;
     iEvent.getByToken(muonsToken_, muons);
+    Handle<ValueMap<int>> muonID;
+    iEvent.getByToken(muonIDToken_, muonID);
     std::unique_ptr<std::vector<pat::Muon>> filteredLooseMuons;
     std::unique_ptr<std::vector<double>> filteredLooseMuonRelIso;
     std::unique_ptr<std::vector<pat::Muon>> filteredMediumMuons;
@@ -155,46 +134,23 @@ PatMuonFilter::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
       if (muons->at(i).pt() < 2.) continue;
       if (std::abs(muons->at(i).eta()) > 2.8) continue;
 
-      auto priVertex = vertices->at(prVtx);
-      auto muon = muons->at(i);
-    
-      bool isLoose = muon::isLooseMuon(muon);
-      bool isMedium = muon::isMediumMuon(muon);
-      bool isTight = (prVtx > -0.5 && muon::isTightMuon(muon,priVertex));
-
-      double mom = muon.p();
-      double dPhiCut_ = std::min(std::max(1.2/mom,1.2/100),0.056);
-      double dPhiBendCut_ = std::min(std::max(0.2/mom,0.2/100),0.0096);
-      bool isLooseME0 = isME0MuonSelNew(muon, 0.077, dPhiCut_, dPhiBendCut_);
-      
-      bool ipxy = false, ipz = false, validPxlHit = false, highPurity = false;
-      if (muon.innerTrack().isNonnull()){
-      	ipxy = std::abs(muon.muonBestTrack()->dxy(priVertex.position())) < 0.2;
-      	ipz = std::abs(muon.muonBestTrack()->dz((priVertex.position()))) < 0.5;
-      	validPxlHit = muon.innerTrack()->hitPattern().numberOfValidPixelHits() > 0;
-      	highPurity = muon.innerTrack()->quality(reco::Track::highPurity);
-      }
-      // isMediumME0 - just loose with track requirements for now, this needs to be updated
-      bool isMediumME0 = isME0MuonSelNew(muon, 0.077, dPhiCut_, dPhiBendCut_) && ipxy && validPxlHit && highPurity;
+      const pat::Muon & muon = muons->at(i);
+      // the ME0 bits are only set for |eta| > 2.4
+      const int bits = muonID->get(muons.id(), i);
 
-      // tighter cuts for tight ME0
-      dPhiCut_ = std::min(std::max(1.2/mom,1.2/100),0.032);
-      dPhiBendCut_ = std::min(std::max(0.2/mom,0.2/100),0.0041);
-      bool isTightME0 = isME0MuonSelNew(muon, 0.048, dPhiCut_, dPhiBendCut_) && ipxy && ipz && validPxlHit && highPurity;
-      
       double relIso = (muon.puppiNoLeptonsChargedHadronIso() + muon.puppiNoLeptonsNeutralHadronIso() + muon.puppiNoLeptonsPhotonIso()) / muon.pt();
       
-      if (isLoose || (std::abs(muon.eta()) > 2.4 && isLooseME0) ){
+      if (pass(bits, MU_LOOSE) || pass(bits, MU_ME0_LOOSE)){
 	looseVec.push_back(muon);
 	looseIsoVec.push_back(relIso);
       }
 
-      if (isMedium || (std::abs(muon.eta()) > 2.4 && isMediumME0) ){
+      if (pass(bits, MU_MEDIUM) || pass(bits, MU_ME0_MEDIUM)){
 	mediumVec.push_back(muon);
 	mediumIsoVec.push_back(relIso);
       }
     
-      if (isTight || (std::abs(muon.eta()) > 2.4 && isTightME0) ){
+      if (pass(bits, MU_TIGHT) || pass(bits, MU_ME0_TIGHT)){
 	tightVec.push_back(muon);
 	tightIsoVec.push_back(relIso);
       }
@@ -229,103 +185,6 @@ void
 PatMuonFilter::endStream() {
 }
 
-// ------------ method to improve ME0 muon ID ----------------
-    bool 
-PatMuonFilter::isME0MuonSel(reco::Muon muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi)
-{
-
-    bool result = false;
-    bool isME0 = muon.isME0Muon();
-
-    if(isME0){
-
-        double deltaX = 999;
-        double deltaY = 999;
-        double pullX = 999;
-        double pullY = 999;
-        double deltaPhi = 999;
-
-        bool X_MatchFound = false, Y_MatchFound = false, Dir_MatchFound = false;
-
-        const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-        for(std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber){
-
-            for (std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment){
-
-                if (chamber->detector() == 5){
-
-                    deltaX   = std::abs(chamber->x - segment->x);
-                    deltaY   = std::abs(chamber->y - segment->y);
-                    pullX    = std::abs(chamber->x - segment->x) / std::sqrt(chamber->xErr + segment->xErr);
-                    pullY    = std::abs(chamber->y - segment->y) / std::sqrt(chamber->yErr + segment->yErr);
-                    deltaPhi = std::abs(atan(chamber->dXdZ) - atan(segment->dXdZ));
-
-                }
-            }
-        }
-
-        if ((pullX < pullXCut) || (deltaX < dXCut)) X_MatchFound = true;
-        if ((pullY < pullYCut) || (deltaY < dYCut)) Y_MatchFound = true;
-        if (deltaPhi < dPhi) Dir_MatchFound = true;
-
-        result = X_MatchFound && Y_MatchFound && Dir_MatchFound;
-
-    }
-
-    return result;
-
-}
-
-bool PatMuonFilter::isME0MuonSelNew(reco::Muon muon, double dEtaCut, double dPhiCut, double dPhiBendCut)
-{
-    
-    bool result = false;
-    bool isME0 = muon.isME0Muon();
-    
-    if(isME0){
-        
-        double deltaEta = 999;
-        double deltaPhi = 999;
-        double deltaPhiBend = 999;
-
-        const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-        for( std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber ){
-            
-            if (chamber->detector() == 5){
-            
-                for ( std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment ){
-
-                    LocalPoint trk_loc_coord(chamber->x, chamber->y, 0);
-                    LocalPoint seg_loc_coord(segment->x, segment->y, 0);
-                    LocalVector trk_loc_vec(chamber->dXdZ, chamber->dYdZ, 1);
-                    LocalVector seg_loc_vec(segment->dXdZ, segment->dYdZ, 1);
-                    
-                    const ME0Chamber * me0chamber = ME0Geometry_->chamber(chamber->id);
-                    
-                    GlobalPoint trk_glb_coord = me0chamber->toGlobal(trk_loc_coord);
-                    GlobalPoint seg_glb_coord = me0chamber->toGlobal(seg_loc_coord);
-                    
-                    //double segDPhi = segment->me0SegmentRef->deltaPhi();
-		    // need to check if this works
-		    double segDPhi = me0chamber->computeDeltaPhi(seg_loc_coord, seg_loc_vec);
-                    double trackDPhi = me0chamber->computeDeltaPhi(trk_loc_coord, trk_loc_vec);
-                    
-                    deltaEta = std::abs(trk_glb_coord.eta() - seg_glb_coord.eta() );
-                    deltaPhi = std::abs(trk_glb_coord.phi() - seg_glb_coord.phi() );
-                    deltaPhiBend = std::abs(segDPhi - trackDPhi);
-                    
-                    if (deltaEta < dEtaCut && deltaPhi < dPhiCut && deltaPhiBend < dPhiBendCut) result = true;
-                    
-                }
-            }
-        }
-        
-    }
-    
-    return result;
-    
-}
-
 // ------------ method called when starting to processes a run  ------------
 /*
    void
@@ -0,0 +1,20 @@
+import FWCore.ParameterSet.Config as cms
+
+# all the working points of the muon ID, computed once per event (ValueMap<int> of objectid::MuonBits)
+muonID = cms.EDProducer('MuonIDProducer',
+        muons                = cms.InputTag("muons"),
+        vertices             = cms.InputTag("offlinePrimaryVertices"),
+        vertexContext        = cms.InputTag("vertexContext"),
+        me0StoredSegmentBend = cms.bool(False),
+)
+
+# RecoMuonFilter reads the bending of the ME0 segments stored in the segments
+muonIDStoredBend = muonID.clone(
+        me0StoredSegmentBend = cms.bool(True),
+)
+
+patMuonID = muonID.clone(
+        muons                = cms.InputTag("slimmedMuons"),
+        vertices             = cms.InputTag("offlineSlimmedPrimaryVertices"),
+        vertexContext        = cms.InputTag("patVertexContext"),
+)
@@ -1,6 +1,6 @@
 import FWCore.ParameterSet.Config as cms
 
 muonfilter = cms.EDProducer('PatMuonFilter',
-        vertices      = cms.InputTag("offlineSlimmedPrimaryVertices"),
         muons         = cms.InputTag("slimmedMuons"),
+        muonID        = cms.InputTag("patMuonID"),
 )
@@ -1,8 +1,8 @@
 import FWCore.ParameterSet.Config as cms
 
 muonfilter = cms.EDProducer('RecoMuonFilter',
-        vertices      = cms.InputTag("offlinePrimaryVertices"),
         muons         = cms.InputTag("muons"),
+        muonID        = cms.InputTag("muonIDStoredBend"),
         puppiNoLepIsolationChargedHadrons = cms.InputTag("muonIsolationPUPPINoLep","h+-DR040-ThresholdVeto000-ConeVeto000"),
         puppiNoLepIsolationNeutralHadrons = cms.InputTag("muonIsolationPUPPINoLep","h0-DR040-ThresholdVeto000-ConeVeto001"),
         puppiNoLepIsolationPhotons        = cms.InputTag("muonIsolationPUPPINoLep","gamma-DR040-ThresholdVeto000-ConeVeto001"),    
@@ -0,0 +1,54 @@
+#include "PhaseTwoAnalysis/Muons/interface/ME0ChamberTable.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "DataFormats/MuonDetId/interface/ME0DetId.h"
+#include "DataFormats/MuonDetId/interface/MuonSubdetId.h"
+#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
+
+ME0ChamberTable::ME0ChamberTable(const ME0Geometry &me0Geom)
+{
+  std::vector<std::pair<uint32_t, const ME0Chamber *>> sorted;
+  for (const ME0Chamber * me0chamber : me0Geom.chambers())
+    sorted.push_back(std::make_pair(me0chamber->id().chamberId().rawId(), me0chamber));
+  std::sort(sorted.begin(), sorted.end());
+
+  ids_.reserve(sorted.size());
+  chambers_.reserve(sorted.size());
+  for (const auto &entry : sorted) {
+    const ME0Chamber * me0chamber = entry.second;
+    const Surface::RotationType &r = me0chamber->rotation();
+    const Surface::PositionType &p = me0chamber->position();
+
+    Chamber chamber;
+    const float rot[9] = {r.xx(), r.xy(), r.xz(), r.yx(), r.yy(), r.yz(), r.zx(), r.zy(), r.zz()};
+    std::copy(rot, rot+9, chamber.rot);
+    chamber.pos[0] = p.x();
+    chamber.pos[1] = p.y();
+    chamber.pos[2] = p.z();
+    chamber.hasBending = me0chamber->nLayers() >= 2;
+    chamber.dzLow = chamber.dzHigh = 0.;
+    if (chamber.hasBending) {
+      // as in ME0Chamber::computeDeltaPhi
+      const float beginOfChamber = me0chamber->layer(1)->position().z();
+      const float centerOfChamber = p.z();
+      const float endOfChamber = me0chamber->layer(me0chamber->nLayers())->position().z();
+      const double sign = centerOfChamber < 0 ? -1.0 : 1.0;
+      chamber.dzLow = sign * (beginOfChamber - centerOfChamber);
+      chamber.dzHigh = sign * (endOfChamber - centerOfChamber);
+    }
+    ids_.push_back(entry.first);
+    chambers_.push_back(chamber);
+  }
+}
+
+  const ME0ChamberTable::Chamber *
+ME0ChamberTable::chamber(DetId id) const
+{
+  if (id.det() != DetId::Muon || id.subdetId() != MuonSubdetId::ME0) return 0;
+  const uint32_t key = ME0DetId(id.rawId()).chamberId().rawId();
+  std::vector<uint32_t>::const_iterator it = std::lower_bound(ids_.begin(), ids_.end(), key);
+  if (it == ids_.end() || *it != key) return 0;
+  return &chambers_[it - ids_.begin()];
+}
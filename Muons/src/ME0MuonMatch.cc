@@ -0,0 +1,38 @@
+#include "PhaseTwoAnalysis/Muons/interface/ME0MuonMatch.h"
+
+#include <cmath>
+
+  void
+ME0MuonMatch::fill(const reco::Muon &muon, const ME0ChamberTable &me0Chambers, bool storedSegmentBend)
+{
+  segments_.clear();
+  if (!muon.isME0Muon()) return;
+
+  for (const reco::MuonChamberMatch &chamber : muon.matches()) {
+    if (chamber.detector() != 5 || chamber.me0Matches.empty()) continue;
+
+    const ME0ChamberTable::Chamber * me0chamber = me0Chambers.chamber(chamber.id);
+    if (!me0chamber) continue;
+    GlobalPoint trk_glb_coord = ME0ChamberTable::toGlobal(*me0chamber, chamber.x, chamber.y);
+    double trackDPhi = ME0ChamberTable::deltaPhi(*me0chamber, chamber.x, chamber.y, chamber.dXdZ, chamber.dYdZ);
+
+    for (const reco::MuonSegmentMatch &segment : chamber.me0Matches) {
+      GlobalPoint seg_glb_coord = ME0ChamberTable::toGlobal(*me0chamber, segment.x, segment.y);
+      double segDPhi = storedSegmentBend ? segment.me0SegmentRef->deltaPhi() : ME0ChamberTable::deltaPhi(*me0chamber, segment.x, segment.y, segment.dXdZ, segment.dYdZ);
+
+      Segment features;
+      features.dEta = std::abs(trk_glb_coord.eta() - seg_glb_coord.eta());
+      features.dPhi = std::abs(trk_glb_coord.phi() - seg_glb_coord.phi());
+      features.dPhiBend = std::abs(segDPhi - trackDPhi);
+      segments_.push_back(features);
+    }
+  }
+}
+
+  bool
+ME0MuonMatch::pass(double dEtaCut, double dPhiCut, double dPhiBendCut) const
+{
+  for (const Segment &segment : segments_)
+    if (segment.dEta < dEtaCut && segment.dPhi < dPhiCut && segment.dPhiBend < dPhiBendCut) return true;
+  return false;
+}
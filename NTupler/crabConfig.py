@@ -12,6 +12,9 @@ config.JobType.pyCfgParams= ['skim=False','inputFormat=PAT','outFileName=MiniEve
 # Uncomment the following line when running on PAT events
 #config.JobType.inputFiles = ['TMVAClassification_BDT.weights.xml']
 config.JobType.outputFiles = ['MiniEvents.root']
+# Uncomment the following lines to run on multicore slots (add 'nThreads=8' to pyCfgParams too)
+#config.JobType.numCores = 8
+#config.JobType.maxMemoryMB = 8000
 
 config.section_("Data")
 config.Data.inputDataset = <'inputDataset'>
@@ -5,44 +5,235 @@
 // Package:     PhaseTwoAnalysis/NTupler
 // Class:       MiniEvent
 // Description: Define the structure of ntuples
+//
+// MiniEvent_t is also the per-event product of the ntuplers (MiniFromPat,
+// MiniFromReco), which is written to the trees by MiniEventWriter.
+// The collections are stored in growable columns (MiniEventBuffer), there
+// is no limit on the number of objects.
+
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
 
 #include "TTree.h"
+#include "TBranch.h"
+#include "TDirectory.h"
+
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventIndex.h"
+
+namespace edm {
+  class ParameterSet;
+  class ParameterSetDescription;
+}
+
+// Growable column of a collection. Writing past the end grows the storage
+// (by doubling) instead of overflowing, so the producers can keep filling
+// ev.col[ev.n] as with the former fixed-size arrays. data() is contiguous,
+// but may move when the column grows: the branches booked on it are
+// re-pointed by MiniEventTrees::fill.
+template<typename T>
+class MiniEventBuffer
+{
+  public:
+    MiniEventBuffer() : v_(16), highWaterMark_(0) {}
+
+    T& operator[](size_t i)
+    {
+      if (i >= v_.size()) v_.resize(std::max(2*v_.size(), i+1));
+      if (i >= highWaterMark_) highWaterMark_ = i+1;
+      return v_[i];
+    }
+    const T& operator[](size_t i) const { return v_[i]; }
+
+    T* data() { return v_.data(); }
+    size_t capacity() const { return v_.size(); }
+    // largest number of entries written
+    size_t highWaterMark() const { return highWaterMark_; }
+
+  private:
+    std::vector<T> v_;
+    size_t highWaterMark_;
+};
 
 struct MiniEvent_t
 {
   MiniEvent_t()
   {
-    ngl=0; ngj=0;  
-    nle=0; nte = 0; nlm=0; ntm=0; nj=0; nmet=0;
+    run=0; event=0; lumi=0;
+    ng=0; ngl=0; ngj=0;  
+    nvtx=0; nle=0; nte = 0; nlm=0; ntm=0; nj=0; nmet=0;
   }
 
-  Int_t run,event,lumi;
+  Int_t run,lumi;
+  Long64_t event;
 
 
   //gen level event
   Int_t ng,ngj,ngl;
-  Float_t gl_p[50], gl_px[50], gl_py[50], gl_pz[50], gl_nrj[50], gl_pt[50], gl_eta[50], gl_phi[50], gl_mass[50], gl_relIso[50];
-  Int_t gl_pid[50], gl_ch[50], gl_st[50];
-  Float_t gj_pt[200], gj_eta[200], gj_phi[200], gj_mass[200];
+  MiniEventBuffer<Float_t> gl_p, gl_px, gl_py, gl_pz, gl_nrj, gl_pt, gl_eta, gl_phi, gl_mass, gl_relIso;
+  MiniEventBuffer<Int_t> gl_pid, gl_ch, gl_st;
+  MiniEventBuffer<Float_t> gj_pt, gj_eta, gj_phi, gj_mass;
 
   //reco level event
   Int_t nvtx;
-  Float_t v_pt2[200];
+  MiniEventBuffer<Float_t> v_pt2;
   Int_t nle, nte, nlm, ntm, nj, nmet;
-  Int_t le_ch[50], le_g[50];
-  Float_t le_pt[50], le_eta[50], le_phi[50], le_mass[50], le_relIso[50];
-  Int_t te_ch[50], te_g[50];
-  Float_t te_pt[50], te_eta[50], te_phi[50], te_mass[50], te_relIso[50];
-  Int_t lm_ch[50], lm_g[50];
-  Float_t lm_pt[50], lm_eta[50], lm_phi[50], lm_mass[50], lm_relIso[50];
-  Int_t tm_ch[50], tm_g[50];
-  Float_t tm_pt[50], tm_eta[50], tm_phi[50], tm_mass[50], tm_relIso[50];
-  Int_t j_id[200], j_g[200], j_mvav2[200], j_deepcsv[200], j_flav[200], j_hadflav[200], j_pid[200];
-  Float_t j_pt[200], j_eta[200], j_phi[200], j_mass[200];
-  Float_t met_pt[10], met_eta[10], met_phi[10];
+  MiniEventBuffer<Int_t> le_ch, le_g;
+  MiniEventBuffer<Float_t> le_pt, le_eta, le_phi, le_mass, le_relIso;
+  MiniEventBuffer<Int_t> te_ch, te_g;
+  MiniEventBuffer<Float_t> te_pt, te_eta, te_phi, te_mass, te_relIso;
+  MiniEventBuffer<Int_t> lm_ch, lm_g;
+  MiniEventBuffer<Float_t> lm_pt, lm_eta, lm_phi, lm_mass, lm_relIso;
+  MiniEventBuffer<Int_t> tm_ch, tm_g;
+  MiniEventBuffer<Float_t> tm_pt, tm_eta, tm_phi, tm_mass, tm_relIso;
+  MiniEventBuffer<Int_t> j_id, j_g, j_mvav2, j_deepcsv, j_flav, j_hadflav, j_pid;
+  MiniEventBuffer<Float_t> j_pt, j_eta, j_phi, j_mass;
+  MiniEventBuffer<Float_t> met_pt, met_eta, met_phi;
+
+};
+
+// layout of the output: ten Delphes-like trees (Event, Particle, ..., PuppiMissingET) filled in lockstep,
+// or a single MiniEvent tree with the branches prefixed by the name of their Delphes-like tree (e.g. JetPUPPI_PT)
+enum MiniEventLayout {DELPHES_LAYOUT = 0, WIDE_LAYOUT};
+
+// "delphes" or "wide", false if the name is unknown
+bool parseMiniEventLayout(const std::string &name, MiniEventLayout &layout);
+
+// Collections (and branches) of the ntuple to produce and write: "JetPUPPI" keeps
+// the whole collection, "Particle.PT" only one branch of it (and its _size
+// counter). The Event header (Run, Event, Lumi) is always kept. The ntuplers
+// neither fetch nor compute what is not kept.
+class MiniEventContent
+{
+  public:
+    // everything is kept
+    MiniEventContent();
+    explicit MiniEventContent(const std::vector<std::string> &keep);
+
+    bool has(const std::string &collection) const;
+    bool has(const std::string &collection, const std::string &branch) const;
+
+    // false if a collection name is not one of the Delphes-like tree names, which is then set in name
+    bool checkNames(std::string &name) const;
+
+  private:
+    bool all_;
+    std::set<std::string> collections_, partial_, branches_;
+};
+
+// names of the trees of a layout, the Delphes-like ones being in the order Event, Particle, Vertex,
+// GenJet, ElectronLoose, ElectronTight, MuonLoose, MuonTight, JetPUPPI, PuppiMissingET
+// (only the kept ones if a content is given)
+std::vector<std::string> miniEventTreeNames(MiniEventLayout layout = DELPHES_LAYOUT, const MiniEventContent &content = MiniEventContent());
 
+// I/O settings of the output trees
+struct MiniEventIOProfile
+{
+  // ROOT defaults: compression of the file, default basket size and AutoFlush
+  MiniEventIOProfile();
+  // from the ioProfile (and customIO) parameters of a writer, throws on an unknown profile or algorithm
+  explicit MiniEventIOProfile(const edm::ParameterSet &iConfig);
+
+  int compression;          // ROOT compression settings (100*algorithm + level), < 0: the ones of the file
+  Int_t basketSize;         // initial basket size in bytes, 0: ROOT default
+  Long64_t optimizeAfter;   // the baskets are resized from the observed entry sizes after this number of entries, 0: never
+  Long64_t autoFlush;       // entries per cluster, the same for all the trees, 0: ROOT default (in bytes, so per tree)
 };
 
-void createMiniEventTree(TTree *t_event_, TTree *t_genParts_, TTree *t_vertices_, TTree *t_genJets_, TTree *t_looseElecs_, TTree *t_tightElecs_, TTree *t_looseMuons_, TTree *t_tightMuons_, TTree *t_puppiJets_, TTree *t_puppiMET_,MiniEvent_t &ev);
+// "default", "fast-write" (LZ4, small clusters) or "archival" (LZMA, large clusters), false if the name is unknown
+bool parseMiniEventIOProfile(const std::string &name, MiniEventIOProfile &profile);
+
+// compression settings for "zlib", "lzma", "lz4" or "zstd", false if the algorithm is unknown;
+// the algorithms missing in the ROOT version fall back to zlib (lz4) and lzma (zstd)
+bool miniEventCompression(const std::string &algorithm, int level, int &settings);
+
+// parameters shared by the ntuple writers (MiniEventWriter, MiniEventStreamWriter): src, layout,
+// collections, compact, writeIndex, ioProfile, customIO and selection
+void fillMiniEventWriterDescription(edm::ParameterSetDescription &desc);
+
+// file written by a writer before being merged into its output, next to the output:
+// ("out/ntuple.root", "ntupleWriter_stream3") -> "out/ntuple_ntupleWriter_stream3.root"
+std::string miniEventTemporaryFileName(const std::string &outputName, const std::string &suffix);
+
+// appends the trees of fileName to merged by fast cloning (the compressed baskets are copied without being
+// unzipped), the merged trees being created in dir from the first file; throws if a tree is missing
+void mergeMiniEventTrees(const std::string &fileName, const std::vector<std::string> &names, TDirectory *dir, std::vector<TTree*> &merged);
+
+// Trees of a layout, created in dir, with the kept branches booked on ev;
+// in compact mode (see MiniEventCompact.h) the eta, phi and mass columns of ev are rounded in place when filling
+class MiniEventTrees
+{
+  public:
+    MiniEventTrees(TDirectory *dir, MiniEvent_t &ev, MiniEventLayout layout = DELPHES_LAYOUT, const MiniEventContent &content = MiniEventContent(), bool compact = false);
+
+    const std::vector<TTree*>& trees() const { return trees_; }
+
+    // to be called before the first fill
+    void setIOProfile(const MiniEventIOProfile &profile);
+
+    // point the branches to the current storage of the columns of ev, then fill all the trees
+    void fill();
+
+    // largest size of each collection so far, e.g. ("JetPUPPI_size", 42)
+    std::vector<std::pair<std::string, Int_t> > highWaterMarks() const;
+
+    // (run, lumi, event) and entry number of each event filled, unsorted
+    const std::vector<MiniEventIndex::Entry>& indexEntries() const { return index_; }
+
+  private:
+    struct Column {
+      TBranch *branch;
+      void *buffer;
+      void *(*data)(void *);
+    };
+    struct Counter {
+      std::string name;
+      const Int_t *size;
+      Int_t highWaterMark;
+    };
+    struct RoundedColumn {
+      MiniEventBuffer<Float_t> *buffer;
+      const Int_t *size;
+      int nbits;
+    };
+    struct FlagColumn {
+      TBranch *branch;
+      const MiniEventBuffer<Int_t> *buffer;
+      const Int_t *size;
+      std::vector<UChar_t> packed;
+    };
+
+    // the collections are indexed in the order of miniEventTreeNames(DELPHES_LAYOUT)
+    void bookBranches();
+    void bookScalar(size_t collection, const char *name, Int_t *address);
+    void bookScalar(size_t collection, const char *name, Long64_t *address);
+    void bookCounter(size_t collection, const char *name, Int_t *size);
+    template<typename T>
+      void bookColumn(size_t collection, const char *name, MiniEventBuffer<T> &buffer, const char *leaf);
+    // the column keeps nbits of mantissa in compact mode
+    void bookRoundedColumn(size_t collection, const char *name, MiniEventBuffer<Float_t> &buffer, const char *leaf, int nbits);
+    // Int_t flags, stored as UChar_t in compact mode (leaf without type, e.g. "[JetPUPPI_size]")
+    void bookFlagColumn(size_t collection, const char *name, MiniEventBuffer<Int_t> &buffer, const char *leaf);
+
+    MiniEvent_t &ev_;
+    MiniEventContent content_;
+    bool compact_;
+    std::vector<TTree*> trees_;
+    std::vector<std::string> collections_;
+    // tree and branch name prefix of each collection, no tree for the dropped ones
+    std::vector<TTree*> collectionTree_;
+    std::vector<std::string> collectionPrefix_;
+    std::vector<Column> columns_;
+    std::vector<Counter> counters_;
+    std::vector<RoundedColumn> roundedColumns_;
+    std::vector<FlagColumn> flagColumns_;
+    // counter of each collection, for the columns converted when filling
+    std::vector<const Int_t*> collectionSize_;
+    Long64_t entries_;
+    MiniEventIOProfile profile_;
+    std::vector<MiniEventIndex::Entry> index_;
+};
 
 #endif
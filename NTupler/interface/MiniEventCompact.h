@@ -0,0 +1,73 @@
+#ifndef _minieventcompact_h_
+#define _minieventcompact_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/NTupler
+// Class:       MiniEventCompact
+// Description: Encoding of the compact ntuples, and helpers to read them back
+//
+// In compact mode (compact = True in MiniEventWriter):
+//   - the jet ID and b-tagging flags are UChar_t bitfields, -1 (not available) being stored as 255
+//   - eta, phi and mass keep 12, 12 and 10 bits of mantissa, the other bits being zeroed so that
+//     they compress away (relative precision of 1.2e-4 and 4.9e-4)
+//   - P, Px, Py, Pz and E of the gen particles are not stored, as they follow from PT, Eta, Phi and Mass
+// The header has no dependency, so that it can be used by the analysis code reading the trees.
+
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+namespace miniEventCompact {
+
+  const int ETA_BITS  = 12;
+  const int PHI_BITS  = 12;
+  const int MASS_BITS = 10;
+
+  const unsigned char NO_FLAGS = 255;
+
+  // keeps nbits (< 23) of the mantissa of x, rounding to the nearest; infinities and NaN are left unchanged
+  inline float reduceMantissa(float x, int nbits)
+  {
+    const int shift = 23 - nbits;
+    uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    if (((i >> 23) & 0xFF) == 0xFF) return x;
+    const uint32_t mask = (0xFFFFFFFFu >> shift) << shift;
+    const uint32_t test = 1u << (shift - 1);
+    i += test;
+    // rounding up the largest finite floats would overflow the exponent
+    if (((i >> 23) & 0xFF) == 0xFF) i -= test;
+    i &= mask;
+    std::memcpy(&x, &i, sizeof(x));
+    return x;
+  }
+
+  inline unsigned char packFlags(int flags)
+  {
+    return flags < 0 ? NO_FLAGS : (unsigned char)flags;
+  }
+
+  inline int unpackFlags(unsigned char flags)
+  {
+    return flags == NO_FLAGS ? -1 : flags;
+  }
+
+  // the gen particle columns dropped in compact mode
+  struct GenMomentum {
+    float p, px, py, pz, e;
+  };
+
+  inline GenMomentum genMomentum(float pt, float eta, float phi, float mass)
+  {
+    GenMomentum m;
+    m.px = pt*std::cos(phi);
+    m.py = pt*std::sin(phi);
+    m.pz = pt*std::sinh(eta);
+    m.p  = pt*std::cosh(eta);
+    m.e  = std::sqrt(m.p*m.p + mass*mass);
+    return m;
+  }
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _minieventindex_h_
+#define _minieventindex_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/NTupler
+// Class:       MiniEventIndex
+// Description: Sorted (run, lumi, event) -> entry index of a MiniEvents file
+//
+// The index is written by the ntuple writers next to the output file
+// (<file>.idx) and memory-mapped by the readers:
+//   - header: the 8 characters "MEVIDX01" and the number of entries (uint64)
+//   - entries: run and lumi (uint32), event and entry (uint64), sorted by
+//     (run, lumi, event), in the byte order of the machine writing the file
+// Lookups are binary searches, joins of two indexes and duplicate searches
+// are single passes over the sorted entries.
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+class MiniEventIndex
+{
+  public:
+    struct Entry {
+      uint32_t run, lumi;
+      uint64_t event;
+      uint64_t entry;
+    };
+
+    // sorts the entries and writes them to fileName, false if the file cannot be written
+    static bool write(const std::string &fileName, std::vector<Entry> entries);
+
+    // maps fileName, see isValid
+    explicit MiniEventIndex(const std::string &fileName);
+    ~MiniEventIndex();
+
+    // false if the file could not be mapped or is not an index
+    bool isValid() const { return entries_ != 0; }
+
+    size_t size() const { return size_; }
+    const Entry* begin() const { return entries_; }
+    const Entry* end() const { return entries_ + size_; }
+
+    // entry number of an event, -1 if it is not in the file
+    int64_t find(uint32_t run, uint32_t lumi, uint64_t event) const;
+
+    // pairs of entries holding the same event (first occurrence, repetition), e.g. after merging overlapping files
+    std::vector<std::pair<uint64_t, uint64_t> > duplicates() const;
+
+  private:
+    MiniEventIndex(const MiniEventIndex&);
+    MiniEventIndex& operator=(const MiniEventIndex&);
+
+    void *map_;
+    size_t mapSize_;
+    const Entry *entries_;
+    size_t size_;
+};
+
+// entry numbers in a and b of the events found in both, in the (run, lumi, event) order
+std::vector<std::pair<uint64_t, uint64_t> > joinMiniEventIndexes(const MiniEventIndex &a, const MiniEventIndex &b);
+
+#endif
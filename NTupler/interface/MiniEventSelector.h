@@ -0,0 +1,47 @@
+#ifndef _minieventselector_h_
+#define _minieventselector_h_
+// -*- C++ -*-
+//
+// Package:     PhaseTwoAnalysis/NTupler
+// Class:       MiniEventSelector
+// Description: Post-selection of the MiniEvent_t to write
+//
+// Counts the objects of a filled MiniEvent_t, stopping as soon as all the
+// minimum multiplicities are reached. The default selector accepts every
+// event. Collections dropped from the content count as empty.
+
+#include <string>
+
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
+
+namespace edm {
+  class ParameterSet;
+  class ParameterSetDescription;
+}
+
+class MiniEventSelector
+{
+  public:
+    // accepts every event
+    MiniEventSelector();
+    // from the selection parameters of a writer, throws on an unknown b-tagger or working point
+    explicit MiniEventSelector(const edm::ParameterSet &selection);
+
+    // the selection parameters, with the defaults accepting every event
+    static void fillDescription(edm::ParameterSetDescription &selection);
+
+    bool accept(const MiniEvent_t &ev) const;
+
+    // loose (ElectronLoose + MuonLoose) and tight (ElectronTight + MuonTight) leptons
+    unsigned int minLooseLeptons, minTightLeptons;
+    // jets with pT > jetPtMin and |eta| < jetEtaMax, and b-tagged ones among them
+    unsigned int minJets, minBJets;
+    float jetPtMin, jetEtaMax;
+    bool bTagDeepCSV;      // DeepCSV, or MVAv2 if false
+    int bTagBit;           // bit of the working point in the JetPUPPI DeepCSV/MVAv2 flags
+
+    // b-tagging working point: "loose", "medium" or "tight", false if the name is unknown
+    bool setBTagWorkingPoint(const std::string &name);
+};
+
+#endif
@@ -0,0 +1,247 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/NTupler
+// Class:      MiniEventStreamWriter
+// 
+/**\class MiniEventStreamWriter MiniEventStreamWriter.cc PhaseTwoAnalysis/NTupler/plugins/MiniEventStreamWriter.cc
+
+Description: writes the MiniEvent_t products to one file per stream and merges them at the end of the job
+
+Implementation:
+   - each stream fills its own ten trees (MiniEventTrees) in a file of its own, so the streams never wait
+     for each other; the file is <output>_<module label>_stream<stream>.root next to the TFileService file,
+     so that two jobs writing different outputs in the same directory do not share stream files, or
+     <fileNamePrefix><stream>.root if fileNamePrefix is set
+   - at endJob the trees are merged into the TFileService file by fast cloning (the compressed baskets are
+     copied without being unzipped), stream after stream, so the entries are grouped by stream and are not
+     in the input order
+   - TBufferMerger is not available in the ROOT version of CMSSW_9_1_X, hence the merge at the end of the job
+   - the per-stream files are removed after the merge unless keepStreamFiles is set
+   - layout: "delphes" (ten trees) or "wide" (one tree with prefixed branches), as for MiniEventWriter
+   - collections: the kept collections and branches, as for MiniEventWriter
+   - compact: as for MiniEventWriter
+   - ioProfile: as for MiniEventWriter, the fast merge keeps the compression and the clusters of the stream files
+   - writeIndex: as for MiniEventWriter, the entries of each stream being shifted by the merge
+   - selection: as for MiniEventWriter, the numbers of accepted and rejected events are summed over the streams
+*/
+
+
+// system include files
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <cstdio>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventSelector.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1.h"
+
+//
+// class declaration
+//
+
+namespace miniEventStreamWriter {
+  struct StreamOutput {
+    TFile* file;
+    MiniEvent_t ev;
+    std::unique_ptr<MiniEventTrees> trees;
+  };
+}
+
+class MiniEventStreamWriter : public edm::global::EDAnalyzer<edm::StreamCache<miniEventStreamWriter::StreamOutput>>  {
+  public:
+    explicit MiniEventStreamWriter(const edm::ParameterSet&);
+    ~MiniEventStreamWriter();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual std::unique_ptr<miniEventStreamWriter::StreamOutput> beginStream(edm::StreamID) const override;
+    virtual void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+    virtual void endStream(edm::StreamID) const override;
+    virtual void endJob() override;
+
+    // ----------member data ---------------------------
+    edm::EDGetTokenT<MiniEvent_t> srcToken_;
+    const std::string fileNamePrefix_;
+    std::string outputName_, moduleLabel_;
+    const bool keepStreamFiles_;
+    MiniEventLayout layout_;
+    const MiniEventContent content_;
+    const bool compact_;
+    const bool writeIndex_;
+    MiniEventIOProfile io_;
+    MiniEventSelector selector_;
+    mutable std::atomic<unsigned long> accepted_, rejected_;
+
+    // files written by the streams, merged at endJob
+    mutable std::mutex filesMutex_;
+    mutable std::vector<std::string> streamFiles_;
+    mutable std::map<std::string, std::vector<MiniEventIndex::Entry> > streamIndex_;
+};
+
+//
+// constructors and destructor
+//
+MiniEventStreamWriter::MiniEventStreamWriter(const edm::ParameterSet& iConfig):
+  srcToken_(consumes<MiniEvent_t>(iConfig.getParameter<edm::InputTag>("src"))),
+  fileNamePrefix_(iConfig.getParameter<std::string>("fileNamePrefix")),
+  outputName_(edm::Service<TFileService>()->file().GetName()),
+  moduleLabel_(iConfig.getParameter<std::string>("@module_label")),
+  keepStreamFiles_(iConfig.getParameter<bool>("keepStreamFiles")),
+  content_(iConfig.getParameter<std::vector<std::string>>("collections")),
+  compact_(iConfig.getParameter<bool>("compact")),
+  writeIndex_(iConfig.getParameter<bool>("writeIndex")),
+  io_(iConfig),
+  selector_(iConfig.getParameterSet("selection")),
+  accepted_(0),
+  rejected_(0)
+{
+  if (!parseMiniEventLayout(iConfig.getParameter<std::string>("layout"), layout_))
+    throw cms::Exception("Configuration") << "MiniEventStreamWriter: unknown layout " << iConfig.getParameter<std::string>("layout");
+  std::string unknown;
+  if (!content_.checkNames(unknown))
+    throw cms::Exception("Configuration") << "MiniEventStreamWriter: unknown collection " << unknown;
+}
+
+
+MiniEventStreamWriter::~MiniEventStreamWriter()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called once each stream before processing any event ------------
+  std::unique_ptr<miniEventStreamWriter::StreamOutput>
+MiniEventStreamWriter::beginStream(edm::StreamID iID) const
+{
+  const std::string fileName = fileNamePrefix_.empty()
+    ? miniEventTemporaryFileName(outputName_, moduleLabel_ + "_stream" + std::to_string(iID.value()))
+    : fileNamePrefix_ + std::to_string(iID.value()) + ".root";
+  std::unique_ptr<miniEventStreamWriter::StreamOutput> out(new miniEventStreamWriter::StreamOutput());
+  out->file = TFile::Open(fileName.c_str(), "RECREATE");
+  if (!out->file || out->file->IsZombie())
+    throw cms::Exception("FileOpenError") << "MiniEventStreamWriter: cannot create " << fileName;
+  out->trees.reset(new MiniEventTrees(out->file, out->ev, layout_, content_, compact_));
+  out->trees->setIOProfile(io_);
+
+  std::lock_guard<std::mutex> lock(filesMutex_);
+  streamFiles_.push_back(fileName);
+  return out;
+}
+
+// ------------ method called for each event  ------------
+  void
+MiniEventStreamWriter::analyze(edm::StreamID iID, const edm::Event& iEvent, const edm::EventSetup& iSetup) const
+{
+  using namespace edm;
+
+  Handle<MiniEvent_t> ev;
+  iEvent.getByToken(srcToken_, ev);
+
+  if (!selector_.accept(*ev)) {
+    rejected_++;
+    return;
+  }
+  accepted_++;
+
+  // the branches of the stream trees point to out.ev
+  miniEventStreamWriter::StreamOutput & out = *streamCache(iID);
+  out.ev = *ev;
+  out.trees->fill();
+}
+
+// ------------ method called once each stream after processing all the events ------------
+  void
+MiniEventStreamWriter::endStream(edm::StreamID iID) const
+{
+  miniEventStreamWriter::StreamOutput & out = *streamCache(iID);
+
+  edm::LogInfo log("MiniEventStreamWriter");
+  log << "stream " << iID.value() << ", largest collection sizes:";
+  for (const std::pair<std::string, Int_t> & mark : out.trees->highWaterMarks()) log << " " << mark.first << "=" << mark.second;
+
+  {
+    std::lock_guard<std::mutex> lock(filesMutex_);
+    streamIndex_[out.file->GetName()] = out.trees->indexEntries();
+  }
+
+  out.file->Write();
+  out.trees.reset();
+  out.file->Close();
+  delete out.file;
+  out.file = 0;
+}
+
+// ------------ method called once each job just after ending the event loop  ------------
+  void
+MiniEventStreamWriter::endJob()
+{
+  edm::Service<TFileService> fs;
+  TDirectory* dir = fs->getBareDirectory();
+
+  const std::vector<std::string> names = miniEventTreeNames(layout_, content_);
+  std::vector<TTree*> merged(names.size(), 0);
+  std::vector<MiniEventIndex::Entry> index;
+  for (size_t f = 0; f < streamFiles_.size(); f++) {
+    // the entries of this stream follow the ones already merged
+    const uint64_t offset = merged[0] ? merged[0]->GetEntries() : 0;
+    for (MiniEventIndex::Entry key : streamIndex_[streamFiles_[f]]) {
+      key.entry += offset;
+      index.push_back(key);
+    }
+    mergeMiniEventTrees(streamFiles_[f], names, dir, merged);
+    if (!keepStreamFiles_) std::remove(streamFiles_[f].c_str());
+  }
+
+  TH1F* selected = fs->make<TH1F>("MiniEventSelection", ";;Events", 2, 0., 2.);
+  selected->GetXaxis()->SetBinLabel(1, "accepted");
+  selected->GetXaxis()->SetBinLabel(2, "rejected");
+  selected->SetBinContent(1, accepted_);
+  selected->SetBinContent(2, rejected_);
+  selected->SetEntries(accepted_ + rejected_);
+
+  const std::string indexName = std::string(fs->file().GetName()) + ".idx";
+  if (writeIndex_ && !MiniEventIndex::write(indexName, index))
+    edm::LogError("MiniEventStreamWriter") << "cannot write the event index " << indexName;
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MiniEventStreamWriter::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  fillMiniEventWriterDescription(desc);
+  // empty: derived from the name of the TFileService file
+  desc.add<std::string>("fileNamePrefix", "");
+  desc.add<bool>("keepStreamFiles", false);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MiniEventStreamWriter);
@@ -0,0 +1,319 @@
+// -*- C++ -*-
+//
+// Package:    PhaseTwoAnalysis/NTupler
+// Class:      MiniEventWriter
+// 
+/**\class MiniEventWriter MiniEventWriter.cc PhaseTwoAnalysis/NTupler/plugins/MiniEventWriter.cc
+
+Description: writes the MiniEvent_t products of MiniFromPat or MiniFromReco to the flat ntuples
+
+Implementation:
+   - the tree structure is defined in MiniEventTrees (src/MiniEvent.cc)
+   - layout: "delphes" for the ten Delphes-like trees read by DAnalysis, "wide" for a single tree with
+     prefixed branches (e.g. JetPUPPI_PT)
+   - one module declaring the TFileService shared resource, so the framework never runs it at the same
+     time as the other modules using TFileService
+   - asynchronous mode (asyncWrite): the products are copied into a ring of queueDepth buffers and a
+     dedicated thread fills the trees (and compresses the baskets), so the event loop only waits when
+     the ring is full; an exception thrown while filling (e.g. a ROOT write error) stops the thread and is
+     rethrown by the next analyze or by endJob
+   - the thread runs outside of the TFileService resource, so it fills the trees of a file owned by this
+     module, <output>_<module label>_async.root next to the TFileService file; at endJob the ring is
+     drained and the trees are merged into the TFileService file by fast cloning (the compressed baskets
+     are copied without being unzipped), then the file is removed
+   - the largest size of each collection is reported at endJob
+   - only the collections and branches listed in 'collections' are booked (see MiniEventContent)
+   - compact: UChar_t flags, eta/phi/mass with a reduced precision and no redundant gen columns (see MiniEventCompact.h)
+   - ioProfile: compression, basket size and AutoFlush of the trees (see MiniEventIOProfile), "default",
+     "fast-write", "archival" or "custom" (customIO); the AutoFlush is given in entries, so that the
+     clusters of the ten trees are aligned
+   - writeIndex: the sorted (run, lumi, event) -> entry index of the output is written to <output file>.idx
+     (see MiniEventIndex); Event is stored as a 64-bit integer
+   - selection: the events failing the MiniEventSelector are not written, the numbers of accepted and
+     rejected events are stored in the MiniEventSelection histogram
+*/
+
+
+// system include files
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdio>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventSelector.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1.h"
+
+//
+// class declaration
+//
+
+class MiniEventWriter : public edm::one::EDAnalyzer<edm::one::SharedResources>  {
+  public:
+    explicit MiniEventWriter(const edm::ParameterSet&);
+    ~MiniEventWriter();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    virtual void beginJob() override;
+    virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
+    virtual void endJob() override;
+
+    void fillTrees();
+    void writeLoop();
+    void stopWriter();
+    void rethrowWriteError();
+
+    // ----------member data ---------------------------
+    edm::Service<TFileService> fs_;
+
+    edm::EDGetTokenT<MiniEvent_t> srcToken_;
+
+    MiniEvent_t ev_;
+    std::unique_ptr<MiniEventTrees> trees_;
+    MiniEventSelector selector_;
+    TH1F* selected_;
+
+    // asynchronous mode: ring_[head_] is the next event to write, queued_ events are waiting,
+    // writeError_ is the exception which stopped the writer thread
+    const bool writeIndex_;
+    const bool asyncWrite_;
+    std::vector<MiniEvent_t> ring_;
+    size_t head_, queued_;
+    bool done_;
+    std::exception_ptr writeError_;
+    // file of the trees filled by the writer thread, merged into the TFileService file at endJob
+    std::string asyncFileName_;
+    TFile* asyncFile_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread writer_;
+};
+
+//
+// constructors and destructor
+//
+MiniEventWriter::MiniEventWriter(const edm::ParameterSet& iConfig):
+  srcToken_(consumes<MiniEvent_t>(iConfig.getParameter<edm::InputTag>("src"))),
+  selector_(iConfig.getParameterSet("selection")),
+  writeIndex_(iConfig.getParameter<bool>("writeIndex")),
+  asyncWrite_(iConfig.getParameter<bool>("asyncWrite")),
+  head_(0),
+  queued_(0),
+  done_(false),
+  asyncFile_(0)
+{
+  MiniEventLayout layout;
+  if (!parseMiniEventLayout(iConfig.getParameter<std::string>("layout"), layout))
+    throw cms::Exception("Configuration") << "MiniEventWriter: unknown layout " << iConfig.getParameter<std::string>("layout");
+  const MiniEventContent content(iConfig.getParameter<std::vector<std::string>>("collections"));
+  std::string unknown;
+  if (!content.checkNames(unknown))
+    throw cms::Exception("Configuration") << "MiniEventWriter: unknown collection " << unknown;
+  if (asyncWrite_) ring_.resize(std::max(1u, iConfig.getParameter<unsigned int>("queueDepth")));
+
+  usesResource("TFileService");
+
+  TDirectory* dir = fs_->getBareDirectory();
+  if (asyncWrite_) {
+    asyncFileName_ = miniEventTemporaryFileName(fs_->file().GetName(), iConfig.getParameter<std::string>("@module_label") + "_async");
+    asyncFile_ = TFile::Open(asyncFileName_.c_str(), "RECREATE");
+    if (!asyncFile_ || asyncFile_->IsZombie())
+      throw cms::Exception("FileOpenError") << "MiniEventWriter: cannot create " << asyncFileName_;
+    dir = asyncFile_;
+  }
+  trees_.reset(new MiniEventTrees(dir, ev_, layout, content, iConfig.getParameter<bool>("compact")));
+  trees_->setIOProfile(MiniEventIOProfile(iConfig));
+  selected_ = fs_->make<TH1F>("MiniEventSelection", ";;Events", 2, 0., 2.);
+  selected_->GetXaxis()->SetBinLabel(1, "accepted");
+  selected_->GetXaxis()->SetBinLabel(2, "rejected");
+}
+
+
+MiniEventWriter::~MiniEventWriter()
+{
+  // endJob is skipped when the job stops on an exception
+  stopWriter();
+  if (asyncFile_) {
+    trees_.reset();
+    asyncFile_->Close();
+    delete asyncFile_;
+    std::remove(asyncFileName_.c_str());
+  }
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called once each job just before starting event loop  ------------
+  void
+MiniEventWriter::beginJob()
+{
+  if (asyncWrite_) writer_ = std::thread(&MiniEventWriter::writeLoop, this);
+}
+
+// ------------ method called for each event  ------------
+  void
+MiniEventWriter::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  using namespace edm;
+
+  Handle<MiniEvent_t> ev;
+  iEvent.getByToken(srcToken_, ev);
+
+  const bool accepted = selector_.accept(*ev);
+  selected_->Fill(accepted ? 0. : 1.);
+  if (!accepted) return;
+
+  if (!asyncWrite_) {
+    // the branches point to ev_
+    ev_ = *ev;
+    fillTrees();
+    return;
+  }
+
+  // wait for a free slot, the writer thread never touches it until it is queued
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return queued_ < ring_.size() || writeError_; });
+  if (writeError_) {
+    lock.unlock();
+    rethrowWriteError();
+  }
+  const size_t slot = (head_ + queued_) % ring_.size();
+  lock.unlock();
+  ring_[slot] = *ev;
+  lock.lock();
+  queued_++;
+  lock.unlock();
+  cond_.notify_all();
+}
+
+// ------------ method called once each job just after ending the event loop  ------------
+  void
+MiniEventWriter::endJob()
+{
+  stopWriter();
+  rethrowWriteError();
+
+  edm::LogInfo log("MiniEventWriter");
+  log << "largest collection sizes:";
+  for (const std::pair<std::string, Int_t> & mark : trees_->highWaterMarks()) log << " " << mark.first << "=" << mark.second;
+
+  const std::string indexName = std::string(fs_->file().GetName()) + ".idx";
+  if (writeIndex_ && !MiniEventIndex::write(indexName, trees_->indexEntries()))
+    edm::LogError("MiniEventWriter") << "cannot write the event index " << indexName;
+
+  if (!asyncFile_) return;
+  // the entries keep their numbers, the trees of the thread being the only ones merged
+  std::vector<std::string> names;
+  for (TTree* t : trees_->trees()) names.push_back(t->GetName());
+  asyncFile_->Write();
+  trees_.reset();
+  asyncFile_->Close();
+  delete asyncFile_;
+  asyncFile_ = 0;
+  std::vector<TTree*> merged(names.size(), 0);
+  mergeMiniEventTrees(asyncFileName_, names, fs_->getBareDirectory(), merged);
+  std::remove(asyncFileName_.c_str());
+}
+
+// ------------ method filling the trees from ev_ ------------
+  void
+MiniEventWriter::fillTrees()
+{
+  trees_->fill();
+}
+
+// ------------ body of the writer thread (asynchronous mode) ------------
+  void
+MiniEventWriter::writeLoop()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return queued_ > 0 || done_; });
+    if (queued_ == 0) return;
+    const size_t slot = head_;
+    lock.unlock();
+    ev_ = ring_[slot];
+    lock.lock();
+    head_ = (head_ + 1) % ring_.size();
+    queued_--;
+    lock.unlock();
+    cond_.notify_all();
+    try {
+      fillTrees();
+    }
+    catch (...) {
+      // the framework cannot see exceptions of this thread, keep it for the event loop
+      lock.lock();
+      writeError_ = std::current_exception();
+      lock.unlock();
+      cond_.notify_all();
+      return;
+    }
+  }
+}
+
+// ------------ method draining the ring and joining the writer thread ------------
+  void
+MiniEventWriter::stopWriter()
+{
+  if (!writer_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cond_.notify_all();
+  writer_.join();
+}
+
+// ------------ method rethrowing the exception which stopped the writer thread, if any ------------
+  void
+MiniEventWriter::rethrowWriteError()
+{
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error = writeError_;
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MiniEventWriter::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  fillMiniEventWriterDescription(desc);
+  desc.add<bool>("asyncWrite", false);
+  desc.add<unsigned int>("queueDepth", 4);
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MiniEventWriter);
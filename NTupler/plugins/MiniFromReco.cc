@@ -5,17 +5,29 @@
 // 
 /**\class MiniFromReco MiniFromReco.cc PhaseTwoAnalysis/NTupler/plugins/MiniFromReco.cc
 
-Description: produces flat ntuples from RECO collections
+Description: produces the MiniEvent_t content of the flat ntuples from RECO collections
    - storing gen, reco, and pf leptons with pT > 10 GeV and |eta| < 3
    - storing gen and reco jets with pT > 20 GeV and |eta| < 5
 
 Implementation:
    - muon isolation comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_isolatio0n
-   - muon ID comes from https://twiki.cern.ch/twiki/bin/viewauth/CMS/Phase2MuonBarrelRecipes#Muon_identification
+   - muon and electron IDs are read from the ValueMaps of packed working point bits of MuonIDProducer
+     (muonID) and RecoElectronIDProducer (electronID), see objectid::MuonBits and objectid::ElectronBits
+   - the primary vertex is read from the VertexContext of VertexContextProducer (vertexContext), the
+     event being left empty without one
    - electron isolation needs to be refined
-   - electron ID comes from https://indico.cern.ch/event/623893/contributions/2531742/attachments/1436144/2208665/UPSG_EGM_Workshop_Mar29.pdf
+   - isolation sums are read from the ValueMaps of MultiConeIsolationProducer
    - no jet ID is stored
    - b-tagging is not available 
+   - global module: the event content is put in the event as a MiniEvent_t and written by MiniEventWriter
+   - only the collections listed in 'collections' (see MiniEventContent) are fetched and computed, e.g. the
+     muon and electron ID bits are not even read when no muon or electron collection is kept
+   - jets and gen jets overlapping with a lepton are removed with the keep-masks of OverlapRemovalProducer
+     (jetKeepMask, genJetKeepMask)
+   - the gen lepton isolation sums the constituents of the selected gen jets, copied once per event into
+     flat arrays (GenJetConstituents)
+   - the gen matching (lm_g, tm_g, le_g, te_g, j_g) is one-to-one, DeltaRMatcher assigning the closest reco-gen
+     pairs first within deltaR < 0.4, once per collection
 
 
 */
@@ -32,19 +44,16 @@ Implementation:
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"//
-#include "FWCore/ServiceRegistry/interface/Service.h"
-#include "CommonTools/UtilAlgos/interface/TFileService.h"
-#include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "DataFormats/MuonReco/interface/Muon.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include "EgammaAnalysis/ElectronTools/interface/ElectronEffectiveArea.h"
-#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
 #include "DataFormats/JetReco/interface/PFJet.h"
@@ -54,14 +63,11 @@ Implementation:
 #include "DataFormats/Candidate/interface/Candidate.h"
 #include "DataFormats/JetReco/interface/GenJet.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
-#include "Geometry/Records/interface/MuonGeometryRecord.h"
-#include "Geometry/GEMGeometry/interface/ME0EtaPartitionSpecs.h"
-#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
+#include "PhaseTwoAnalysis/Common/interface/DeltaRMatcher.h"
+#include "PhaseTwoAnalysis/Common/interface/GenJetConstituents.h"
+#include "PhaseTwoAnalysis/Common/interface/ObjectIDBits.h"
+#include "PhaseTwoAnalysis/Common/interface/VertexContext.h"
 
-#include "FWCore/Framework/interface/ESHandle.h"
-
-#include "DataFormats/MuonReco/interface/MuonSelectors.h"
-#include "RecoEgamma/Phase2InterimID/interface/HGCalIDTool.h"
 #include "DataFormats/Common/interface/Ptr.h"
 
 #include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
@@ -71,75 +77,43 @@ Implementation:
 #include "TH2.h"
 #include "TTree.h"
 #include "TLorentzVector.h"
-#include "Math/GenVector/VectorUtil.h"
-#include "TMVA/Reader.h" 
-#include "TMVA/MethodBDT.h" 
 
 //
 // class declaration
 //
 
-// If the analyzer does not use TFileService, please remove
-// the template argument to the base class so the class inherits
-// from  edm::one::EDAnalyzer<> and also remove the line from
-// constructor "usesResource("TFileService");"
-// This will improve performance in multithreaded jobs.
-
-class MiniFromReco : public edm::one::EDAnalyzer<edm::one::SharedResources, edm::one::WatchRuns>  {
+class MiniFromReco : public edm::global::EDProducer<>  {
   public:
     explicit MiniFromReco(const edm::ParameterSet&);
     ~MiniFromReco();
 
     static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
 
-    enum ElectronMatchType {UNMATCHED = 0,
-      TRUE_PROMPT_ELECTRON,
-      TRUE_ELECTRON_FROM_TAU,
-      TRUE_NON_PROMPT_ELECTRON};  
-
   private:
-    virtual void beginJob() override;
-    virtual void beginRun(edm::Run const&, edm::EventSetup const&) override;
-    void genAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup);
-    void recoAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup);
-    virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
-    virtual void endRun(edm::Run const&, edm::EventSetup const&) override;
-    virtual void endJob() override;
-
-    bool isME0MuonSel(reco::Muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi);
-    bool isME0MuonSelNew(reco::Muon, double, double, double);    
-    bool isLooseElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    bool isMediumElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    bool isTightElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal);
-    int matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles);
-    void findFirstNonElectronMother(const reco::Candidate *particle, int &ancestorPID, int &ancestorStatus);
-    float evalMVAElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, double isoEl, int vertexSize);
+    void genAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup, MiniEvent_t& ev) const;
+    void recoAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup, MiniEvent_t& ev) const;
+    virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
 
     // ----------member data ---------------------------
-    edm::Service<TFileService> fs_;
-
-    std::unique_ptr<HGCalIDTool> hgcEmId_; 
-    TMVA::Reader tmvaReader_;
-    float hgcId_startPosition, hgcId_lengthCompatibility, hgcId_sigmaietaieta, hgcId_deltaEtaStartPosition, hgcId_deltaPhiStartPosition, hOverE_hgcalSafe, hgcId_cosTrackShowerAngle, trackIsoR04jurassic_D_pt, ooEmooP, d0, dz, pt, etaSC, phiSC, nPV, expectedMissingInnerHits, passConversionVeto, isTrue;
+    MiniEventContent content_;
+    bool keepGenParts_, keepGenIso_, keepGenJets_, keepElecs_, keepMuons_, keepJets_, keepMET_;
 
     edm::EDGetTokenT<std::vector<reco::GsfElectron>> elecsToken_;
-    edm::EDGetTokenT<reco::BeamSpot> bsToken_;
-    edm::EDGetTokenT<std::vector<reco::Conversion>> convToken_;
-    edm::EDGetTokenT<edm::ValueMap<double>> trackIsoValueMapToken_;
+    edm::EDGetTokenT<edm::ValueMap<int>> elecIDToken_;
     edm::EDGetTokenT<std::vector<reco::Muon>> muonsToken_;
+    edm::EDGetTokenT<edm::ValueMap<int>> muonIDToken_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_charged_hadrons_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_neutral_hadrons_;
     edm::EDGetTokenT<edm::ValueMap<float> > PUPPINoLeptonsIsolation_photons_;
-    edm::EDGetTokenT<std::vector<reco::PFCandidate>> pfCandsNoLepToken_;
+    std::vector<edm::EDGetTokenT<edm::ValueMap<float>>> elecIsolationTokens_;
     edm::EDGetTokenT<std::vector<reco::PFJet>> jetsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> jetKeepMaskToken_;
     edm::EDGetTokenT<std::vector<reco::PFMET>> metToken_;
     edm::EDGetTokenT<std::vector<reco::GenParticle>> genPartsToken_;
     edm::EDGetTokenT<std::vector<reco::GenJet>> genJetsToken_;
+    edm::EDGetTokenT<edm::ValueMap<bool>> genJetKeepMaskToken_;
     edm::EDGetTokenT<std::vector<reco::Vertex>> verticesToken_;
-    const ME0Geometry* ME0Geometry_; 
-
-    TTree *t_event_, *t_genParts_, *t_vertices_, *t_genJets_, *t_looseElecs_, *t_tightElecs_, *t_looseMuons_, *t_tightMuons_, *t_puppiJets_, *t_puppiMET_;
-    MiniEvent_t ev_;
+    edm::EDGetTokenT<VertexContext> vertexContextToken_;
 
 };
 
@@ -155,62 +129,48 @@ class MiniFromReco : public edm::one::EDAnalyzer<edm::one::SharedResources, edm:
 // constructors and destructor
 //
 MiniFromReco::MiniFromReco(const edm::ParameterSet& iConfig): 
-  elecsToken_(consumes<std::vector<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-  bsToken_(consumes<reco::BeamSpot>(iConfig.getParameter<edm::InputTag>("beamspot"))),
-  convToken_(consumes<std::vector<reco::Conversion>>(iConfig.getParameter<edm::InputTag>("conversions"))),
-  trackIsoValueMapToken_(consumes<edm::ValueMap<double>>(iConfig.getParameter<edm::InputTag>("trackIsoValueMap"))),
-  muonsToken_(consumes<std::vector<reco::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
-  pfCandsNoLepToken_(consumes<std::vector<reco::PFCandidate>>(iConfig.getParameter<edm::InputTag>("pfCandsNoLep"))),
-  jetsToken_(consumes<std::vector<reco::PFJet>>(iConfig.getParameter<edm::InputTag>("jets"))),
-  metToken_(consumes<std::vector<reco::PFMET>>(iConfig.getParameter<edm::InputTag>("met"))),
-  genPartsToken_(consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genParts"))),
-  genJetsToken_(consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genJets"))),
-  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices")))
+  content_(iConfig.getParameter<std::vector<std::string>>("collections")),
+  keepGenParts_(content_.has("Particle")),
+  keepGenIso_(content_.has("Particle", "IsolationVar")),
+  keepGenJets_(content_.has("GenJet")),
+  keepElecs_(content_.has("ElectronLoose") || content_.has("ElectronTight")),
+  keepMuons_(content_.has("MuonLoose") || content_.has("MuonTight")),
+  keepJets_(content_.has("JetPUPPI")),
+  keepMET_(content_.has("PuppiMissingET")),
+  verticesToken_(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vertices"))),
+  vertexContextToken_(consumes<VertexContext>(iConfig.getParameter<edm::InputTag>("vertexContext")))
 {
   //now do what ever initialization is needed
-  PUPPINoLeptonsIsolation_charged_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationChargedHadrons"));
-  PUPPINoLeptonsIsolation_neutral_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationNeutralHadrons"));
-  PUPPINoLeptonsIsolation_photons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationPhotons"));
-
-  usesResource("TFileService");
-
-  const edm::ParameterSet& hgcIdCfg = iConfig.getParameterSet("HGCalIDToolConfig");
-  auto cc = consumesCollector();
-  hgcEmId_.reset( new HGCalIDTool(hgcIdCfg, cc) );
-
-  tmvaReader_.SetOptions("!Color:Silent:!Error");
-  tmvaReader_.AddVariable("hgcId_startPosition", &hgcId_startPosition);
-  tmvaReader_.AddVariable("hgcId_lengthCompatibility", &hgcId_lengthCompatibility);
-  tmvaReader_.AddVariable("hgcId_sigmaietaieta", &hgcId_sigmaietaieta);
-  tmvaReader_.AddVariable("abs(hgcId_deltaEtaStartPosition)", &hgcId_deltaEtaStartPosition);
-  tmvaReader_.AddVariable("abs(hgcId_deltaPhiStartPosition)", &hgcId_deltaPhiStartPosition);
-  tmvaReader_.AddVariable("hOverE_hgcalSafe", &hOverE_hgcalSafe);
-  tmvaReader_.AddVariable("hgcId_cosTrackShowerAngle", &hgcId_cosTrackShowerAngle);
-  tmvaReader_.AddVariable("trackIsoR04jurassic_D_pt := trackIsoR04jurassic/pt", &trackIsoR04jurassic_D_pt);
-  tmvaReader_.AddVariable("abs(ooEmooP)", &ooEmooP);
-  tmvaReader_.AddVariable("abs(d0)", &d0);
-  tmvaReader_.AddVariable("abs(dz)", &dz);
-  tmvaReader_.AddVariable("expectedMissingInnerHits", &expectedMissingInnerHits);
-  tmvaReader_.AddSpectator("pt",  &pt);
-  tmvaReader_.AddSpectator("nPV",  &nPV);
-  tmvaReader_.AddSpectator("etaSC",  &etaSC);
-  tmvaReader_.AddSpectator("phiSC",  &phiSC);
-  tmvaReader_.AddSpectator("isTrue",  &isTrue);
-  tmvaReader_.AddSpectator("passConversionVeto", &passConversionVeto);
-
-  tmvaReader_.BookMVA("PhaseIIEndcapHGCal","TMVAClassification_BDT.weights.xml");
-
-  t_event_      = fs_->make<TTree>("Event","Event");
-  t_genParts_   = fs_->make<TTree>("Particle","Particle");
-  t_vertices_   = fs_->make<TTree>("Vertex","Vertex");
-  t_genJets_    = fs_->make<TTree>("GenJet","GenJet");
-  t_looseElecs_ = fs_->make<TTree>("ElectronLoose","ElectronLoose");
-  t_tightElecs_ = fs_->make<TTree>("ElectronTight","ElectronTight");
-  t_looseMuons_ = fs_->make<TTree>("MuonLoose","MuonLoose");
-  t_tightMuons_ = fs_->make<TTree>("MuonTight","MuonTight");
-  t_puppiJets_  = fs_->make<TTree>("JetPUPPI","JetPUPPI");
-  t_puppiMET_   = fs_->make<TTree>("PuppiMissingET","PuppiMissingET");
-  createMiniEventTree(t_event_, t_genParts_, t_vertices_, t_genJets_, t_looseElecs_, t_tightElecs_, t_looseMuons_, t_tightMuons_, t_puppiJets_, t_puppiMET_, ev_);
+  std::string unknown;
+  if (!content_.checkNames(unknown))
+    throw cms::Exception("Configuration") << "MiniFromReco: unknown collection '" << unknown << "'";
+
+  // the jets and gen jets are cleaned from the leptons with the keep-masks of OverlapRemovalProducer
+  if (keepElecs_) {
+    elecsToken_ = consumes<std::vector<reco::GsfElectron>>(iConfig.getParameter<edm::InputTag>("electrons"));
+    elecIDToken_ = consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("electronID"));
+    for (const edm::InputTag& tag : iConfig.getParameter<std::vector<edm::InputTag>>("elecIsolation"))
+      elecIsolationTokens_.push_back(consumes<edm::ValueMap<float>>(tag));
+  }
+  if (keepMuons_) {
+    muonsToken_ = consumes<std::vector<reco::Muon>>(iConfig.getParameter<edm::InputTag>("muons"));
+    muonIDToken_ = consumes<edm::ValueMap<int>>(iConfig.getParameter<edm::InputTag>("muonID"));
+    PUPPINoLeptonsIsolation_charged_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationChargedHadrons"));
+    PUPPINoLeptonsIsolation_neutral_hadrons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationNeutralHadrons"));
+    PUPPINoLeptonsIsolation_photons_ = consumes<edm::ValueMap<float> >(iConfig.getParameter<edm::InputTag>("puppiNoLepIsolationPhotons"));
+  }
+  if (keepJets_) {
+    jetsToken_ = consumes<std::vector<reco::PFJet>>(iConfig.getParameter<edm::InputTag>("jets"));
+    jetKeepMaskToken_ = consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("jetKeepMask"));
+  }
+  if (keepMET_) metToken_ = consumes<std::vector<reco::PFMET>>(iConfig.getParameter<edm::InputTag>("met"));
+  if (keepGenParts_) genPartsToken_ = consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genParts"));
+  if (keepGenJets_ || keepGenIso_) {
+    genJetsToken_ = consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genJets"));
+    genJetKeepMaskToken_ = consumes<edm::ValueMap<bool>>(iConfig.getParameter<edm::InputTag>("genJetKeepMask"));
+  }
+
+  produces<MiniEvent_t>();
 }
 
 
@@ -229,141 +189,122 @@ MiniFromReco::~MiniFromReco()
 
 // ------------ method to fill gen level event -------------
   void
-MiniFromReco::genAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+MiniFromReco::genAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup, MiniEvent_t& ev) const
 {
   using namespace edm;
 
+  if (!keepGenParts_ && !keepGenJets_) return;
+
   Handle<std::vector<reco::GenParticle>> genParts;
-  iEvent.getByToken(genPartsToken_, genParts);
+  if (keepGenParts_) iEvent.getByToken(genPartsToken_, genParts);
 
   Handle<std::vector<reco::GenJet>> genJets;
-  iEvent.getByToken(genJetsToken_, genJets);
+  Handle<ValueMap<bool>> genJetKeepMask;
+  if (keepGenJets_ || keepGenIso_) {
+    iEvent.getByToken(genJetsToken_, genJets);
+    iEvent.getByToken(genJetKeepMaskToken_, genJetKeepMask);
+  }
 
   // Jets
-  std::vector<size_t> jGenJets;
-  ev_.ngj = 0;
-  for (size_t i = 0; i < genJets->size(); i++) {
+  // constituents of the selected gen jets, for the gen lepton isolation
+  GenJetConstituents genJetConstituents;
+  ev.ngj = 0;
+  for (size_t i = 0; genJets.isValid() && i < genJets->size(); i++) {
     if (genJets->at(i).pt() < 25.) continue;
     if (fabs(genJets->at(i).eta()) > 5) continue;
 
-    bool overlaps = false;
-    for (size_t j = 0; j < genParts->size(); j++) {
-      if (abs(genParts->at(j).pdgId()) != 11 && abs(genParts->at(j).pdgId()) != 13) continue;
-      if (fabs(genJets->at(i).pt()-genParts->at(j).pt()) < 0.01*genParts->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(genParts->at(j).p4(),genJets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    jGenJets.push_back(i);
-
-    ev_.gj_pt[ev_.ngj]   = genJets->at(i).pt();
-    ev_.gj_phi[ev_.ngj]  = genJets->at(i).phi();
-    ev_.gj_eta[ev_.ngj]  = genJets->at(i).eta();
-    ev_.gj_mass[ev_.ngj] = genJets->at(i).mass();
-    ev_.ngj++;
+    if (!genJetKeepMask->get(genJets.id(), i)) continue;
+    if (keepGenIso_) genJetConstituents.addJet(genJets->at(i));
+    if (!keepGenJets_) continue;
+
+    ev.gj_pt[ev.ngj]   = genJets->at(i).pt();
+    ev.gj_phi[ev.ngj]  = genJets->at(i).phi();
+    ev.gj_eta[ev.ngj]  = genJets->at(i).eta();
+    ev.gj_mass[ev.ngj] = genJets->at(i).mass();
+    ev.ngj++;
   }
 
   // Leptons
-  ev_.ngl = 0;
-  for (size_t i = 0; i < genParts->size(); i++) {
+  ev.ngl = 0;
+  for (size_t i = 0; keepGenParts_ && i < genParts->size(); i++) {
     if (abs(genParts->at(i).pdgId()) != 11 && abs(genParts->at(i).pdgId()) != 13) continue;
     if (genParts->at(i).pt() < 20.) continue;
     if (fabs(genParts->at(i).eta()) > 3.) continue;
+    // cone of 0.4 for the muons and 0.3 for the electrons
+    const float dRIso = (abs(genParts->at(i).pdgId()) == 13 ? 0.4 : 0.3);
     double genIso = 0.;
-    for (size_t j = 0; j < jGenJets.size(); j++) {
-      if (ROOT::Math::VectorUtil::DeltaR(genParts->at(i).p4(),genJets->at(jGenJets[j]).p4()) > 0.7) continue; 
-      std::vector<const reco::Candidate *> jconst = genJets->at(jGenJets[j]).getJetConstituentsQuick();
-      for (size_t k = 0; k < jconst.size(); k++) {
-        double deltaR = ROOT::Math::VectorUtil::DeltaR(genParts->at(i).p4(),jconst[k]->p4());
-        if (deltaR < 0.01) continue;
-        if (abs(genParts->at(i).pdgId()) == 13 && deltaR > 0.4) continue;
-        if (abs(genParts->at(i).pdgId()) == 11 && deltaR > 0.3) continue;
-        genIso = genIso + jconst[k]->pt();
-      }
-    }
+    if (keepGenIso_) genIso = genJetConstituents.sumPt(genParts->at(i).eta(), genParts->at(i).phi(), 0.7, 0.01, dRIso);
     genIso = genIso / genParts->at(i).pt();
-    ev_.gl_pid[ev_.ngl]    = genParts->at(i).pdgId();
-    ev_.gl_ch[ev_.ngl]     = genParts->at(i).charge();
-    ev_.gl_st[ev_.ngl]     = genParts->at(i).status();
-    ev_.gl_p[ev_.ngl]      = genParts->at(i).p();
-    ev_.gl_px[ev_.ngl]     = genParts->at(i).px();
-    ev_.gl_py[ev_.ngl]     = genParts->at(i).py();
-    ev_.gl_pz[ev_.ngl]     = genParts->at(i).pz();
-    ev_.gl_nrj[ev_.ngl]    = genParts->at(i).energy();
-    ev_.gl_pt[ev_.ngl]     = genParts->at(i).pt();
-    ev_.gl_phi[ev_.ngl]    = genParts->at(i).phi();
-    ev_.gl_eta[ev_.ngl]    = genParts->at(i).eta();
-    ev_.gl_mass[ev_.ngl]   = genParts->at(i).mass();
-    ev_.gl_relIso[ev_.ngl] = genIso; 
-    ev_.ngl++;
+    ev.gl_pid[ev.ngl]    = genParts->at(i).pdgId();
+    ev.gl_ch[ev.ngl]     = genParts->at(i).charge();
+    ev.gl_st[ev.ngl]     = genParts->at(i).status();
+    ev.gl_p[ev.ngl]      = genParts->at(i).p();
+    ev.gl_px[ev.ngl]     = genParts->at(i).px();
+    ev.gl_py[ev.ngl]     = genParts->at(i).py();
+    ev.gl_pz[ev.ngl]     = genParts->at(i).pz();
+    ev.gl_nrj[ev.ngl]    = genParts->at(i).energy();
+    ev.gl_pt[ev.ngl]     = genParts->at(i).pt();
+    ev.gl_phi[ev.ngl]    = genParts->at(i).phi();
+    ev.gl_eta[ev.ngl]    = genParts->at(i).eta();
+    ev.gl_mass[ev.ngl]   = genParts->at(i).mass();
+    ev.gl_relIso[ev.ngl] = genIso; 
+    ev.ngl++;
   }
 
 }
 
 // ------------ method to fill reco level pat -------------
   void
-MiniFromReco::recoAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+MiniFromReco::recoAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSetup, MiniEvent_t& ev) const
 {
   using namespace edm;
 
-  hgcEmId_->getEventSetup(iSetup);
-  hgcEmId_->getEvent(iEvent);
-
-  Handle<std::vector<reco::GsfElectron>> elecs;
-  iEvent.getByToken(elecsToken_, elecs);
-  Handle<reco::ConversionCollection> conversions;
-  iEvent.getByToken(convToken_, conversions);
-  Handle<reco::BeamSpot> bsHandle;
-  iEvent.getByToken(bsToken_, bsHandle);
-  const reco::BeamSpot &beamspot = *bsHandle.product();
-  Handle<ValueMap<double>> trackIsoValueMap;
-  iEvent.getByToken(trackIsoValueMapToken_, trackIsoValueMap);
-
-  Handle<std::vector<reco::Muon>> muons;
-  iEvent.getByToken(muonsToken_, muons);
-  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_charged_hadrons;
-  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_neutral_hadrons;
-  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_photons;
-  iEvent.getByToken(PUPPINoLeptonsIsolation_charged_hadrons_, PUPPINoLeptonsIsolation_charged_hadrons);
-  iEvent.getByToken(PUPPINoLeptonsIsolation_neutral_hadrons_, PUPPINoLeptonsIsolation_neutral_hadrons);
-  iEvent.getByToken(PUPPINoLeptonsIsolation_photons_, PUPPINoLeptonsIsolation_photons);  
-
-  Handle<std::vector<reco::PFCandidate>> pfCandsNoLep;
-  iEvent.getByToken(pfCandsNoLepToken_, pfCandsNoLep);
-
-  Handle<std::vector<reco::PFJet>> jets;
-  iEvent.getByToken(jetsToken_, jets);
-
-  Handle<std::vector<reco::PFMET>> met;
-  iEvent.getByToken(metToken_, met);
-
-  Handle<std::vector<reco::GenParticle>> genParts;
-  iEvent.getByToken(genPartsToken_, genParts);
-
-  Handle<std::vector<reco::GenJet>> genJets;
-  iEvent.getByToken(genJetsToken_, genJets);
-
   Handle<std::vector<reco::Vertex>> vertices;
   iEvent.getByToken(verticesToken_, vertices);
+  Handle<VertexContext> vtxContext;
+  iEvent.getByToken(vertexContextToken_, vtxContext);
 
-  int prVtx = -1;
-  ev_.nvtx = 0;
+  ev.nvtx = 0;
   for(size_t i = 0; i < vertices->size(); i++) {
     if (vertices->at(i).isFake()) continue;
     if (vertices->at(i).ndof() <= 4.) continue;
-    if (prVtx < 0) prVtx = i;
-    ev_.v_pt2[ev_.nvtx] = vertices->at(i).p4().pt();
-    ev_.nvtx++;
+    ev.v_pt2[ev.nvtx] = vertices->at(i).p4().pt();
+    ev.nvtx++;
+  }
+  if (!vtxContext->hasPrimaryVertex()) return;
+
+  Handle<std::vector<reco::GsfElectron>> elecs;
+  Handle<ValueMap<int>> elecID;
+  if (keepElecs_) {
+    iEvent.getByToken(elecsToken_, elecs);
+    iEvent.getByToken(elecIDToken_, elecID);
   }
-  if (prVtx < 0.) return;
+
+  Handle<std::vector<reco::Muon>> muons;
+  Handle<ValueMap<int>> muonID;
+  if (keepMuons_) {
+    iEvent.getByToken(muonsToken_, muons);
+    iEvent.getByToken(muonIDToken_, muonID);
+  }
+
+  // one-to-one gen matching, closest pairs first
+  DeltaRMatcher genMatcher(0.4);
 
   // Muons
 
-  ev_.nlm = 0;
-  ev_.ntm = 0;
+  ev.nlm = 0;
+  ev.ntm = 0;
+
+  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_charged_hadrons;
+  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_neutral_hadrons;
+  edm::Handle<edm::ValueMap<float>> PUPPINoLeptonsIsolation_photons;
+  if (keepMuons_) {
+    iEvent.getByToken(PUPPINoLeptonsIsolation_charged_hadrons_, PUPPINoLeptonsIsolation_charged_hadrons);
+    iEvent.getByToken(PUPPINoLeptonsIsolation_neutral_hadrons_, PUPPINoLeptonsIsolation_neutral_hadrons);
+    iEvent.getByToken(PUPPINoLeptonsIsolation_photons_, PUPPINoLeptonsIsolation_photons);  
+  }
 
-  for(size_t i = 0; i < muons->size(); i++){
+  for(size_t i = 0; keepMuons_ && i < muons->size(); i++){
     if (muons->at(i).pt() < 2.) continue;
     if (fabs(muons->at(i).eta()) > 2.8) continue;
 
@@ -373,502 +314,146 @@ MiniFromReco::recoAnalysis(const edm::Event& iEvent, const edm::EventSetup& iSet
     double muon_puppiIsoNoLep_Photon = (*PUPPINoLeptonsIsolation_photons)[muref];
     double isoMu = (muon_puppiIsoNoLep_ChargedHadron+muon_puppiIsoNoLep_NeutralHadron+muon_puppiIsoNoLep_Photon)/muons->at(i).pt();
 
-    // Loose ID
-    double dPhiCut = std::min(std::max(1.2/muons->at(i).p(),1.2/100),0.056);
-    double dPhiBendCut = std::min(std::max(0.2/muons->at(i).p(),0.2/100),0.0096);    
-    bool isLoose = (fabs(muons->at(i).eta()) < 2.4 && muon::isLooseMuon(muons->at(i))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.077, dPhiCut, dPhiBendCut));
-
-    // Medium ID -- needs to be updated
-    bool ipxy = false, ipz = false, validPxlHit = false, highPurity = false;
-    if (muons->at(i).innerTrack().isNonnull()){
-    	ipxy = std::abs(muons->at(i).muonBestTrack()->dxy(vertices->at(prVtx).position())) < 0.2;
-    	ipz = std::abs(muons->at(i).muonBestTrack()->dz(vertices->at(prVtx).position())) < 0.5;
-    	validPxlHit = muons->at(i).innerTrack()->hitPattern().numberOfValidPixelHits() > 0;
-    	highPurity = muons->at(i).innerTrack()->quality(reco::Track::highPurity);
-    }    
-    // bool isMedium = (fabs(muons->at(i).eta()) < 2.4 && muon::isMediumMuon(muons->at(i))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.077, dPhiCut, dPhiBendCut) && ipxy && ipz && validPxlHit && highPurity);
-
-    // Tight ID
-    dPhiCut = std::min(std::max(1.2/muons->at(i).p(),1.2/100),0.032);
-    dPhiBendCut = std::min(std::max(0.2/muons->at(i).p(),0.2/100),0.0041);
-    bool isTight = (fabs(muons->at(i).eta()) < 2.4 && vertices->size() > 0 && muon::isTightMuon(muons->at(i),vertices->at(prVtx))) || (fabs(muons->at(i).eta()) > 2.4 && isME0MuonSelNew(muons->at(i), 0.048, dPhiCut, dPhiBendCut) && ipxy && ipz && validPxlHit && highPurity);
+    // standard IDs within |eta| < 2.4, ME0 IDs beyond
+    const int idBits = muonID->get(muons.id(), i);
+    const bool inBarrel = fabs(muons->at(i).eta()) < 2.4;
+    bool isLoose = (inBarrel && objectid::pass(idBits, objectid::MU_LOOSE)) || objectid::pass(idBits, objectid::MU_ME0_LOOSE);
+    bool isTight = (inBarrel && objectid::pass(idBits, objectid::MU_TIGHT)) || objectid::pass(idBits, objectid::MU_ME0_TIGHT);
 
     if (!isLoose) continue;
 
-    ev_.lm_ch[ev_.nlm]     = muons->at(i).charge();
-    ev_.lm_pt[ev_.nlm]     = muons->at(i).pt();
-    ev_.lm_phi[ev_.nlm]    = muons->at(i).phi();
-    ev_.lm_eta[ev_.nlm]    = muons->at(i).eta();
-    ev_.lm_mass[ev_.nlm]   = muons->at(i).mass();
-    ev_.lm_relIso[ev_.nlm] = isoMu;
-    ev_.lm_g[ev_.nlm] = -1;
-    for (int ig = 0; ig < ev_.ngl; ig++) {
-      if (abs(ev_.gl_pid[ig]) != 13) continue;
-      if (reco::deltaR(ev_.gl_eta[ig],ev_.gl_phi[ig],ev_.lm_eta[ev_.nlm],ev_.lm_phi[ev_.nlm]) > 0.4) continue;
-      ev_.lm_g[ev_.nlm]    = ig;
-    }
-    ev_.nlm++;
+    ev.lm_ch[ev.nlm]     = muons->at(i).charge();
+    ev.lm_pt[ev.nlm]     = muons->at(i).pt();
+    ev.lm_phi[ev.nlm]    = muons->at(i).phi();
+    ev.lm_eta[ev.nlm]    = muons->at(i).eta();
+    ev.lm_mass[ev.nlm]   = muons->at(i).mass();
+    ev.lm_relIso[ev.nlm] = isoMu;
+    ev.nlm++;
 
     if (!isTight) continue;
 
-    ev_.tm_ch[ev_.ntm]     = muons->at(i).charge();
-    ev_.tm_pt[ev_.ntm]     = muons->at(i).pt();
-    ev_.tm_phi[ev_.ntm]    = muons->at(i).phi();
-    ev_.tm_eta[ev_.ntm]    = muons->at(i).eta();
-    ev_.tm_mass[ev_.ntm]   = muons->at(i).mass();
-    ev_.tm_relIso[ev_.ntm] = isoMu;
-    ev_.tm_g[ev_.ntm] = -1;
-    for (int ig = 0; ig < ev_.ngl; ig++) {
-      if (abs(ev_.gl_pid[ig]) != 13) continue;
-      if (reco::deltaR(ev_.gl_eta[ig],ev_.gl_phi[ig],ev_.tm_eta[ev_.ntm],ev_.tm_phi[ev_.ntm]) > 0.4) continue;
-      ev_.tm_g[ev_.ntm]    = ig;
-    }
-    ev_.ntm++;
+    ev.tm_ch[ev.ntm]     = muons->at(i).charge();
+    ev.tm_pt[ev.ntm]     = muons->at(i).pt();
+    ev.tm_phi[ev.ntm]    = muons->at(i).phi();
+    ev.tm_eta[ev.ntm]    = muons->at(i).eta();
+    ev.tm_mass[ev.ntm]   = muons->at(i).mass();
+    ev.tm_relIso[ev.ntm] = isoMu;
+    ev.ntm++;
 
   }
+  genMatcher.match(ev.lm_eta, ev.lm_phi, ev.nlm, ev.gl_eta, ev.gl_phi, ev.ngl, [&ev](size_t ig) { return abs(ev.gl_pid[ig]) == 13; }, ev.lm_g);
+  genMatcher.match(ev.tm_eta, ev.tm_phi, ev.ntm, ev.gl_eta, ev.gl_phi, ev.ngl, [&ev](size_t ig) { return abs(ev.gl_pid[ig]) == 13; }, ev.tm_g);
 
   // Electrons
 
-  ev_.nle = 0;
-  ev_.nte = 0;
+  ev.nle = 0;
+  ev.nte = 0;
+
+  std::vector<Handle<ValueMap<float>>> elecIsolation(elecIsolationTokens_.size());
+  for (size_t k = 0; keepElecs_ && k < elecIsolationTokens_.size(); k++) iEvent.getByToken(elecIsolationTokens_[k], elecIsolation[k]);
 
-  for(size_t i = 0; i < elecs->size(); i++) { 
+  for(size_t i = 0; keepElecs_ && i < elecs->size(); i++) { 
     if (elecs->at(i).pt() < 10.) continue;
     if (fabs(elecs->at(i).eta()) > 3.) continue;
 
+    Ptr<const reco::GsfElectron> el4iso(elecs,i);
     double isoEl = 0.;
-    for (size_t k = 0; k < pfCandsNoLep->size(); k++) {
-      if (ROOT::Math::VectorUtil::DeltaR(elecs->at(i).p4(),pfCandsNoLep->at(k).p4()) > 0.4) continue;
-      isoEl += pfCandsNoLep->at(k).pt();
-    }
+    for (size_t k = 0; k < elecIsolation.size(); k++) isoEl += (*elecIsolation[k])[el4iso];
     if (elecs->at(i).pt() > 0.) isoEl = isoEl / elecs->at(i).pt(); 
     else isoEl = -1.;
 
-    Ptr<const reco::GsfElectron> el4iso(elecs,i);
-    double eljurassicIso = (*trackIsoValueMap)[el4iso];
-    double elpt = elecs->at(i).pt();
-    double elMVAVal = -1.;
-    if (hgcEmId_->setElectronPtr(&(elecs->at(i)))) 
-      elMVAVal = (double)evalMVAElec(elecs->at(i),vertices->at(prVtx),conversions,beamspot,genParts,eljurassicIso/elpt,vertices->size());
-    bool isLoose  = isLooseElec(elecs->at(i),conversions,beamspot,elMVAVal);    
-    // bool isMedium = isMediumElec(elecs->at(i),conversions,beamspot,elMVAVal);    
-    bool isTight  = isTightElec(elecs->at(i),conversions,beamspot,elMVAVal);    
+    const int idBits = elecID->get(elecs.id(), i);
+    bool isLoose  = objectid::pass(idBits, objectid::ELE_LOOSE);
+    bool isTight  = objectid::pass(idBits, objectid::ELE_TIGHT);
 
     if (!isLoose) continue;
 
-    ev_.le_ch[ev_.nle]     = elecs->at(i).charge();
-    ev_.le_pt[ev_.nle]     = elecs->at(i).pt();
-    ev_.le_phi[ev_.nle]    = elecs->at(i).phi();
-    ev_.le_eta[ev_.nle]    = elecs->at(i).eta();
-    ev_.le_mass[ev_.nle]   = elecs->at(i).mass();
-    ev_.le_relIso[ev_.nle] = isoEl;
-    ev_.le_g[ev_.nle] = -1;
-    for (int ig = 0; ig < ev_.ngl; ig++) {
-      if (abs(ev_.gl_pid[ig]) != 11) continue;
-      if (reco::deltaR(ev_.gl_eta[ig],ev_.gl_phi[ig],ev_.le_eta[ev_.nle],ev_.le_phi[ev_.nle]) > 0.4) continue;
-      ev_.le_g[ev_.nle]    = ig;
-    }
-    ev_.nle++;
+    ev.le_ch[ev.nle]     = elecs->at(i).charge();
+    ev.le_pt[ev.nle]     = elecs->at(i).pt();
+    ev.le_phi[ev.nle]    = elecs->at(i).phi();
+    ev.le_eta[ev.nle]    = elecs->at(i).eta();
+    ev.le_mass[ev.nle]   = elecs->at(i).mass();
+    ev.le_relIso[ev.nle] = isoEl;
+    ev.nle++;
 
     if (!isTight) continue;
 
-    ev_.te_ch[ev_.nte]     = elecs->at(i).charge();
-    ev_.te_pt[ev_.nte]     = elecs->at(i).pt();
-    ev_.te_phi[ev_.nte]    = elecs->at(i).phi();
-    ev_.te_eta[ev_.nte]    = elecs->at(i).eta();
-    ev_.te_mass[ev_.nte]   = elecs->at(i).mass();
-    ev_.te_relIso[ev_.nte] = isoEl;
-    ev_.te_g[ev_.nte] = -1;
-    for (int ig = 0; ig < ev_.ngl; ig++) {
-      if (abs(ev_.gl_pid[ig]) != 11) continue;
-      if (reco::deltaR(ev_.gl_eta[ig],ev_.gl_phi[ig],ev_.te_eta[ev_.nte],ev_.te_phi[ev_.nte]) > 0.4) continue;
-      ev_.te_g[ev_.nte]    = ig;
-    }
-    ev_.nte++;
+    ev.te_ch[ev.nte]     = elecs->at(i).charge();
+    ev.te_pt[ev.nte]     = elecs->at(i).pt();
+    ev.te_phi[ev.nte]    = elecs->at(i).phi();
+    ev.te_eta[ev.nte]    = elecs->at(i).eta();
+    ev.te_mass[ev.nte]   = elecs->at(i).mass();
+    ev.te_relIso[ev.nte] = isoEl;
+    ev.nte++;
 
   }
+  genMatcher.match(ev.le_eta, ev.le_phi, ev.nle, ev.gl_eta, ev.gl_phi, ev.ngl, [&ev](size_t ig) { return abs(ev.gl_pid[ig]) == 11; }, ev.le_g);
+  genMatcher.match(ev.te_eta, ev.te_phi, ev.nte, ev.gl_eta, ev.gl_phi, ev.ngl, [&ev](size_t ig) { return abs(ev.gl_pid[ig]) == 11; }, ev.te_g);
 
   // Jets
-  ev_.nj = 0;
-  for(size_t i = 0; i < jets->size(); i++){
+  ev.nj = 0;
+
+  Handle<std::vector<reco::PFJet>> jets;
+  Handle<ValueMap<bool>> jetKeepMask;
+  if (keepJets_) {
+    iEvent.getByToken(jetsToken_, jets);
+    iEvent.getByToken(jetKeepMaskToken_, jetKeepMask);
+  }
+
+  for(size_t i = 0; keepJets_ && i < jets->size(); i++){
     if (jets->at(i).pt() < 20.) continue;
     if (fabs(jets->at(i).eta()) > 5) continue;
 
-    bool overlaps = false;
-    for (size_t j = 0; j < elecs->size(); j++) {
-      if (fabs(jets->at(i).pt()-elecs->at(j).pt()) < 0.01*elecs->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(elecs->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-    for (size_t j = 0; j < muons->size(); j++) {
-      if (fabs(jets->at(i).pt()-muons->at(j).pt()) < 0.01*muons->at(j).pt() && ROOT::Math::VectorUtil::DeltaR(muons->at(j).p4(),jets->at(i).p4()) < 0.01) {
-        overlaps = true;
-        break;
-      }
-    }
-    if (overlaps) continue;
-
-    ev_.j_id[ev_.nj]      = -1;
-    ev_.j_pt[ev_.nj]      = jets->at(i).pt();
-    ev_.j_phi[ev_.nj]     = jets->at(i).phi();
-    ev_.j_eta[ev_.nj]     = jets->at(i).eta();
-    ev_.j_mass[ev_.nj]    = jets->at(i).mass();
-    ev_.j_mvav2[ev_.nj]   = -1; 
-    ev_.j_deepcsv[ev_.nj] = -1;
-    ev_.j_flav[ev_.nj]    = -1;
-    ev_.j_hadflav[ev_.nj] = -1;
-    ev_.j_pid[ev_.nj]     = -1;
-    ev_.j_g[ev_.nj] = -1;
-    for (int ig = 0; ig < ev_.ngj; ig++) {
-      if (reco::deltaR(ev_.gj_eta[ig],ev_.gj_phi[ig],ev_.j_eta[ev_.nj],ev_.j_phi[ev_.nj]) > 0.4) continue;
-      ev_.j_g[ev_.nj]     = ig;
-      break;
-    }	
-    ev_.nj++;
+    if (!jetKeepMask->get(jets.id(), i)) continue;
+
+    ev.j_id[ev.nj]      = -1;
+    ev.j_pt[ev.nj]      = jets->at(i).pt();
+    ev.j_phi[ev.nj]     = jets->at(i).phi();
+    ev.j_eta[ev.nj]     = jets->at(i).eta();
+    ev.j_mass[ev.nj]    = jets->at(i).mass();
+    ev.j_mvav2[ev.nj]   = -1; 
+    ev.j_deepcsv[ev.nj] = -1;
+    ev.j_flav[ev.nj]    = -1;
+    ev.j_hadflav[ev.nj] = -1;
+    ev.j_pid[ev.nj]     = -1;
+    ev.nj++;
 
   }
+  genMatcher.match(ev.j_eta, ev.j_phi, ev.nj, ev.gj_eta, ev.gj_phi, ev.ngj, ev.j_g);
 
   // MET 
-  ev_.nmet = 0;
-  if (met->size() > 0) {
-    ev_.met_pt[ev_.nmet]  = met->at(0).pt();
-    ev_.met_eta[ev_.nmet] = met->at(0).eta();
-    ev_.met_phi[ev_.nmet] = met->at(0).phi();
-    ev_.nmet++;
+  ev.nmet = 0;
+
+  Handle<std::vector<reco::PFMET>> met;
+  if (keepMET_) iEvent.getByToken(metToken_, met);
+
+  if (keepMET_ && met->size() > 0) {
+    ev.met_pt[ev.nmet]  = met->at(0).pt();
+    ev.met_eta[ev.nmet] = met->at(0).eta();
+    ev.met_phi[ev.nmet] = met->at(0).phi();
+    ev.nmet++;
   }
   
 }
 
-// ------------ method called for each event  ------------
+// ------------ method called to produce the data  ------------
   void
-MiniFromReco::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+MiniFromReco::produce(edm::StreamID iID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
 
   //analyze the event
-  if(!iEvent.isRealData()) genAnalysis(iEvent, iSetup);
-  recoAnalysis(iEvent, iSetup);
+  std::unique_ptr<MiniEvent_t> ev(new MiniEvent_t());
+  if(!iEvent.isRealData()) genAnalysis(iEvent, iSetup, *ev);
+  recoAnalysis(iEvent, iSetup, *ev);
   
-  //save event if at least one lepton at gen or reco level
-  ev_.run     = iEvent.id().run();
-  ev_.lumi    = iEvent.luminosityBlock();
-  ev_.event   = iEvent.id().event(); 
-  t_event_->Fill();
-  t_genParts_->Fill();
-  t_vertices_->Fill();
-  t_genJets_->Fill();
-  t_looseElecs_->Fill();
-  t_tightElecs_->Fill();
-  t_looseMuons_->Fill();
-  t_tightMuons_->Fill();
-  t_puppiJets_->Fill();
-  t_puppiMET_->Fill();
-
-}
-
-// ------------ method to improve ME0 muon ID ----------------
-  bool 
-MiniFromReco::isME0MuonSel(reco::Muon muon, double pullXCut, double dXCut, double pullYCut, double dYCut, double dPhi)
-{
-
-  bool result = false;
-  bool isME0 = muon.isME0Muon();
-
-  if(isME0){
-
-    double deltaX = 999;
-    double deltaY = 999;
-    double pullX = 999;
-    double pullY = 999;
-    double deltaPhi = 999;
-
-    bool X_MatchFound = false, Y_MatchFound = false, Dir_MatchFound = false;
-
-    const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-    for(std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber){
-
-      for (std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment){
-
-        if (chamber->detector() == 5){
-
-          deltaX   = std::abs(chamber->x - segment->x);
-          deltaY   = std::abs(chamber->y - segment->y);
-          pullX    = std::abs(chamber->x - segment->x) / std::sqrt(chamber->xErr + segment->xErr);
-          pullY    = std::abs(chamber->y - segment->y) / std::sqrt(chamber->yErr + segment->yErr);
-          deltaPhi = std::abs(atan(chamber->dXdZ) - atan(segment->dXdZ));
-
-        }
-      }
-    }
-
-    if ((pullX < pullXCut) || (deltaX < dXCut)) X_MatchFound = true;
-    if ((pullY < pullYCut) || (deltaY < dYCut)) Y_MatchFound = true;
-    if (deltaPhi < dPhi) Dir_MatchFound = true;
-
-    result = X_MatchFound && Y_MatchFound && Dir_MatchFound;
-
-  }
-
-  return result;
+  //the event is saved by MiniEventWriter
+  ev->run     = iEvent.id().run();
+  ev->lumi    = iEvent.luminosityBlock();
+  ev->event   = iEvent.id().event(); 
+  iEvent.put(std::move(ev));
 
 }
 
-bool 
-MiniFromReco::isME0MuonSelNew(reco::Muon muon, double dEtaCut, double dPhiCut, double dPhiBendCut)
-{
-
-  bool result = false;
-  bool isME0 = muon.isME0Muon();
-
-  if(isME0){
-
-    double deltaEta = 999;
-    double deltaPhi = 999;
-    double deltaPhiBend = 999;
-
-    const std::vector<reco::MuonChamberMatch>& chambers = muon.matches();
-    for( std::vector<reco::MuonChamberMatch>::const_iterator chamber = chambers.begin(); chamber != chambers.end(); ++chamber ){
-
-      if (chamber->detector() == 5){
-
-        for ( std::vector<reco::MuonSegmentMatch>::const_iterator segment = chamber->me0Matches.begin(); segment != chamber->me0Matches.end(); ++segment ){
-
-          LocalPoint trk_loc_coord(chamber->x, chamber->y, 0);
-          LocalPoint seg_loc_coord(segment->x, segment->y, 0);
-          LocalVector trk_loc_vec(chamber->dXdZ, chamber->dYdZ, 1);
-          LocalVector seg_loc_vec(segment->dXdZ, segment->dYdZ, 1);
-
-          const ME0Chamber * me0chamber = ME0Geometry_->chamber(chamber->id);
-
-          GlobalPoint trk_glb_coord = me0chamber->toGlobal(trk_loc_coord);
-          GlobalPoint seg_glb_coord = me0chamber->toGlobal(seg_loc_coord);
-
-          //double segDPhi = segment->me0SegmentRef->deltaPhi();
-          // need to check if this works
-          double segDPhi = me0chamber->computeDeltaPhi(seg_loc_coord, seg_loc_vec);
-          double trackDPhi = me0chamber->computeDeltaPhi(trk_loc_coord, trk_loc_vec);
-
-          deltaEta = std::abs(trk_glb_coord.eta() - seg_glb_coord.eta() );
-          deltaPhi = std::abs(trk_glb_coord.phi() - seg_glb_coord.phi() );
-          deltaPhiBend = std::abs(segDPhi - trackDPhi);
-
-          if (deltaEta < dEtaCut && deltaPhi < dPhiCut && deltaPhiBend < dPhiBendCut) result = true;
-
-        }
-      }
-    }
-
-  }
-
-  return result;
-
-}
-
-// ------------ loose elec ID -----------
-bool 
-MiniFromReco::isLooseElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isLoose = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.02992
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.004119
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.05176
-      && recoEl.hcalOverEcal() < 6.741
-      && Ooemoop < 73.76
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 2.5
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isLoose = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isLoose : (MVAVal > -0.01)); 
-}
-
-// ------------ medium elec ID -----------
-bool 
-MiniFromReco::isMediumElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isMedium = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.01609
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.001766
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.03130
-      && recoEl.hcalOverEcal() < 7.371
-      && Ooemoop < 22.6
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 1.325
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isMedium = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isMedium : (MVAVal > 0.03));  
-}
-
-// ------------ tight elec ID -----------
-bool 
-MiniFromReco::isTightElec(const reco::GsfElectron & recoEl, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, double MVAVal) {
-  bool isTight = false;
-  double Ooemoop = 999.;
-  if (recoEl.ecalEnergy()==0) Ooemoop = 999.;
-  else if (!std::isfinite(recoEl.ecalEnergy())) Ooemoop = 998.;
-  else Ooemoop = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  if (fabs(recoEl.superCluster()->eta()) < 1.479
-      && recoEl.full5x5_sigmaIetaIeta() < 0.01614
-      && fabs(recoEl.deltaEtaSuperClusterTrackAtVtx()) < 0.001322
-      && fabs(recoEl.deltaPhiSuperClusterTrackAtVtx()) < 0.06129
-      && recoEl.hcalOverEcal() < 4.492
-      && Ooemoop < 18.26
-      && recoEl.pfIsolationVariables().sumChargedHadronPt / recoEl.pt() < 1.255
-      && !ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) 
-    isTight = true;
-
-  return (fabs(recoEl.superCluster()->eta()) < 1.556 ? isTight : (MVAVal > 0.1)); 
-}
-
-// ------------ match reco elec to gen elec ------------
-int 
-MiniFromReco::matchToTruth(const reco::GsfElectron & recoEl, const edm::Handle<std::vector<reco::GenParticle>> & genParticles) {
-  // 
-  // Explicit loop and geometric matching method (advised by Josh Bendavid)
-  //
-
-  // Find the closest status 1 gen electron to the reco electron
-  double dR = 999;
-  const reco::Candidate *closestElectron = 0;
-  for(size_t i=0; i<genParticles->size();i++){
-    const reco::Candidate *particle = &(*genParticles)[i];
-    // Drop everything that is not electron or not status 1
-    if(abs(particle->pdgId()) != 11 || particle->status() != 1)
-      continue;
-    //
-    double dRtmp = ROOT::Math::VectorUtil::DeltaR( recoEl.p4(), particle->p4() );
-    if(dRtmp < dR){
-      dR = dRtmp;
-      closestElectron = particle;
-    }
-  }
-  // See if the closest electron (if it exists) is close enough.
-  // If not, no match found.
-  if(!(closestElectron != 0 && dR < 0.1)) {
-    return UNMATCHED;
-  }
-
-  // 
-  int ancestorPID = -999; 
-  int ancestorStatus = -999;
-  findFirstNonElectronMother(closestElectron, ancestorPID, ancestorStatus);
-
-  if(ancestorPID == -999 && ancestorStatus == -999){
-    // No non-electron parent??? This should never happen.
-    // Complain.
-    printf("SimpleElectronNtupler: ERROR! Electron does not apper to have a non-electron parent\n");
-    return UNMATCHED;
-  }
-
-  if(abs(ancestorPID) > 50 && ancestorStatus == 2)
-    return TRUE_NON_PROMPT_ELECTRON;
-
-  if(abs(ancestorPID) == 15 && ancestorStatus == 2)
-    return TRUE_ELECTRON_FROM_TAU;
-
-  // What remains is true prompt electrons
-  return TRUE_PROMPT_ELECTRON;
-}
-void 
-MiniFromReco::findFirstNonElectronMother(const reco::Candidate *particle,
-    int &ancestorPID, int &ancestorStatus) {
-
-  if(particle == 0){
-    printf("SimpleElectronNtupler: ERROR! null candidate pointer, this should never happen\n");
-    return;
-  }
-
-  // Is this the first non-electron parent? If yes, return, otherwise
-  // go deeper into recursion
-  if(abs(particle->pdgId()) == 11){
-    findFirstNonElectronMother(particle->mother(0), ancestorPID, ancestorStatus);
-  }else{
-    ancestorPID = particle->pdgId();
-    ancestorStatus = particle->status();
-  }
-
-  return;
-}
-
-// ------------ tight HGCal electron ID --------------
-float 
-MiniFromReco::evalMVAElec(const reco::GsfElectron & recoEl, const reco::Vertex & recoVtx, edm::Handle<reco::ConversionCollection> conversions, const reco::BeamSpot beamspot, const edm::Handle<std::vector<reco::GenParticle>> & genParticles, double isoEl, int vertexSize) {
-
-  if (fabs(recoEl.superCluster()->eta()) < 1.556) return -1.;
-
-  bool isHGCal = hgcEmId_->setElectronPtr(&recoEl);
-  if (isHGCal)  {
-    hgcId_startPosition = std::abs(hgcEmId_->getClusterStartPosition().z());
-    hgcId_lengthCompatibility = hgcEmId_->getClusterLengthCompatibility();
-    hgcId_sigmaietaieta = hgcEmId_->getClusterSigmaEtaEta();
-    hgcId_deltaEtaStartPosition = recoEl.trackPositionAtCalo().eta() - hgcEmId_->getClusterStartPosition().eta();
-    hgcId_deltaPhiStartPosition = reco::deltaPhi(recoEl.trackPositionAtCalo().phi(), hgcEmId_->getClusterStartPosition().phi());
-    hOverE_hgcalSafe = hgcEmId_->getClusterHadronFraction();
-    hgcId_cosTrackShowerAngle = recoEl.trackMomentumOut().Unit().Dot(hgcEmId_->getClusterShowerAxis().Unit());
-  } else {
-    hgcId_startPosition = -1.;
-    hgcId_lengthCompatibility = -1.;
-    hgcId_sigmaietaieta = recoEl.full5x5_sigmaIetaIeta();
-    hgcId_deltaEtaStartPosition = -1.;
-    hgcId_deltaPhiStartPosition = -1.;
-    hOverE_hgcalSafe = recoEl.hcalOverEcal();
-    hgcId_cosTrackShowerAngle = -1.;
-  }
-  trackIsoR04jurassic_D_pt = (float)isoEl;
-  ooEmooP = 1e30;
-  if (recoEl.ecalEnergy() == 0) ooEmooP = 1e30;
-  else if (!std::isfinite(recoEl.ecalEnergy())) ooEmooP = 1e30;
-  else ooEmooP = fabs(1.0/recoEl.ecalEnergy() - recoEl.eSuperClusterOverP()/recoEl.ecalEnergy());
-  d0 = recoEl.gsfTrack()->dxy(recoVtx.position());
-  dz = recoEl.gsfTrack()->dz(recoVtx.position());
-  pt = recoEl.pt();
-  etaSC = recoEl.superCluster()->eta();
-  phiSC = recoEl.superCluster()->phi();
-
-  expectedMissingInnerHits = (float)recoEl.gsfTrack()->hitPattern().numberOfHits(reco::HitPattern::MISSING_INNER_HITS);
-  isTrue = (float)matchToTruth(recoEl, genParticles);
-  nPV = (float)vertexSize;
-  if (!ConversionTools::hasMatchedConversion(recoEl, conversions, beamspot.position())) passConversionVeto = 1.;
-  else passConversionVeto = 0.;
-
-  return (isHGCal ? tmvaReader_.EvaluateMVA("PhaseIIEndcapHGCal") : -1.);
-}
-
-
-// ------------ method called once each job just before starting event loop  ------------
-  void 
-MiniFromReco::beginJob()
-{
-}
-
-// ------------ method called once each run ----------------
-  void
-MiniFromReco::beginRun(edm::Run const& iRun, edm::EventSetup const& iSetup)
-{
-  edm::ESHandle<ME0Geometry> hGeom;
-  iSetup.get<MuonGeometryRecord>().get(hGeom);
-  ME0Geometry_ =( &*hGeom);
-}
-
-// ------------ method called when ending the processing of a run  ------------
-  void
-MiniFromReco::endRun(edm::Run const&, edm::EventSetup const&)
-{
-}
-
-// ------------ method called once each job just after ending the event loop  ------------
-  void 
-MiniFromReco::endJob() 
-{
-}
 
 // ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
 void
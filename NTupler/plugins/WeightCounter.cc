@@ -22,7 +22,7 @@ Implementation:
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -39,7 +39,7 @@ Implementation:
 // class declaration
 //
 
-class WeightCounter : public edm::EDAnalyzer {
+class WeightCounter : public edm::one::EDAnalyzer<edm::one::SharedResources> {
   public:
     explicit WeightCounter(const edm::ParameterSet&);
     ~WeightCounter();
@@ -76,6 +76,7 @@ WeightCounter::WeightCounter(const edm::ParameterSet& iConfig) :
   genEventInfoToken_(consumes<GenEventInfoProduct>(edm::InputTag("generator")))
 {
   //now do what ever initialization is needed
+  usesResource("TFileService");
 
 }
 
@@ -0,0 +1,31 @@
+import FWCore.ParameterSet.Config as cms
+
+ntupleWriter = cms.EDAnalyzer('MiniEventStreamWriter',
+        src             = cms.InputTag("ntuple"),
+        layout          = cms.string("delphes"),
+        collections     = cms.vstring("Particle", "Vertex", "GenJet", "ElectronLoose", "ElectronTight",
+                                      "MuonLoose", "MuonTight", "JetPUPPI", "PuppiMissingET"),
+        compact         = cms.bool(False),
+        writeIndex      = cms.bool(True),
+        ioProfile       = cms.string("default"),
+        customIO        = cms.PSet(
+            compressionAlgorithm = cms.string("zlib"),
+            compressionLevel     = cms.int32(4),
+            basketSize           = cms.int32(32000),
+            optimizeAfter        = cms.uint32(1000),
+            autoFlush            = cms.uint32(10000),
+        ),
+        selection       = cms.PSet(
+            minLooseLeptons  = cms.uint32(0),
+            minTightLeptons  = cms.uint32(0),
+            minJets          = cms.uint32(0),
+            minBJets         = cms.uint32(0),
+            jetPtMin         = cms.double(20.),
+            jetEtaMax        = cms.double(5.),
+            bTagger          = cms.string("DeepCSV"),
+            bTagWorkingPoint = cms.string("medium"),
+        ),
+        # stream files <output>_ntupleWriter_stream<N>.root next to the TFileService file if empty
+        fileNamePrefix  = cms.string(""),
+        keepStreamFiles = cms.bool(False),
+)
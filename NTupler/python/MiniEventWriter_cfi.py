@@ -0,0 +1,30 @@
+import FWCore.ParameterSet.Config as cms
+
+ntupleWriter = cms.EDAnalyzer('MiniEventWriter',
+        src           = cms.InputTag("ntuple"),
+        layout        = cms.string("delphes"),
+        collections   = cms.vstring("Particle", "Vertex", "GenJet", "ElectronLoose", "ElectronTight",
+                                    "MuonLoose", "MuonTight", "JetPUPPI", "PuppiMissingET"),
+        compact       = cms.bool(False),
+        writeIndex    = cms.bool(True),
+        ioProfile     = cms.string("default"),
+        customIO      = cms.PSet(
+            compressionAlgorithm = cms.string("zlib"),
+            compressionLevel     = cms.int32(4),
+            basketSize           = cms.int32(32000),
+            optimizeAfter        = cms.uint32(1000),
+            autoFlush            = cms.uint32(10000),
+        ),
+        selection     = cms.PSet(
+            minLooseLeptons  = cms.uint32(0),
+            minTightLeptons  = cms.uint32(0),
+            minJets          = cms.uint32(0),
+            minBJets         = cms.uint32(0),
+            jetPtMin         = cms.double(20.),
+            jetEtaMax        = cms.double(5.),
+            bTagger          = cms.string("DeepCSV"),
+            bTagWorkingPoint = cms.string("medium"),
+        ),
+        asyncWrite    = cms.bool(False),
+        queueDepth    = cms.uint32(4),
+)
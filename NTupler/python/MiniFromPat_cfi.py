@@ -1,14 +1,19 @@
 import FWCore.ParameterSet.Config as cms
 
-ntuple = cms.EDAnalyzer('MiniFromPat',
-        pileup        = cms.uint32(200),
+ntuple = cms.EDProducer('MiniFromPat',
+        collections   = cms.vstring("Particle", "Vertex", "GenJet", "ElectronLoose", "ElectronTight",
+                                    "MuonLoose", "MuonTight", "JetPUPPI", "PuppiMissingET"),
         vertices      = cms.InputTag("offlineSlimmedPrimaryVertices"),
+        vertexContext = cms.InputTag("patVertexContext"),
         electrons     = cms.InputTag("slimmedElectrons"),
-        beamspot      = cms.InputTag("offlineBeamSpot"),
-        conversions   = cms.InputTag("reducedEgamma", "reducedConversions", "PAT"),
+        electronID    = cms.InputTag("patElectronID"),
         muons         = cms.InputTag("slimmedMuons"),
+        muonID        = cms.InputTag("patMuonID"),
         jets          = cms.InputTag("slimmedJetsPuppi"),
+        jetID         = cms.InputTag("patJetID"),
+        jetKeepMask   = cms.InputTag("patJetLeptonOverlaps"),
         mets          = cms.InputTag("slimmedMETsPuppi"),
         genParts      = cms.InputTag("packedGenParticles"),
         genJets       = cms.InputTag("slimmedGenJets"),
+        genJetKeepMask = cms.InputTag("patGenJetLeptonOverlaps"),
 )
@@ -1,28 +1,26 @@
 import FWCore.ParameterSet.Config as cms
 
-ntuple = cms.EDAnalyzer('MiniFromReco',
+ntuple = cms.EDProducer('MiniFromReco',
+        collections  = cms.vstring("Particle", "Vertex", "GenJet", "ElectronLoose", "ElectronTight",
+                                   "MuonLoose", "MuonTight", "JetPUPPI", "PuppiMissingET"),
         electrons    = cms.InputTag("ecalDrivenGsfElectrons"),
-        beamspot     = cms.InputTag("offlineBeamSpot"),
-        conversions  = cms.InputTag("particleFlowEGamma"),
-        trackIsoValueMap = cms.InputTag("electronTrackIsolationLcone"),
+        electronID   = cms.InputTag("electronID"),
         muons        = cms.InputTag("muons"),
+        muonID       = cms.InputTag("muonID"),
         puppiNoLepIsolationChargedHadrons = cms.InputTag("muonIsolationPUPPINoLep","h+-DR040-ThresholdVeto000-ConeVeto000"),
         puppiNoLepIsolationNeutralHadrons = cms.InputTag("muonIsolationPUPPINoLep","h0-DR040-ThresholdVeto000-ConeVeto001"),
         puppiNoLepIsolationPhotons        = cms.InputTag("muonIsolationPUPPINoLep","gamma-DR040-ThresholdVeto000-ConeVeto001"),    
-        pfCandsNoLep = cms.InputTag("particleFlow"),
+        elecIsolation = cms.VInputTag(cms.InputTag("leptonIsolation","electrons-h+-DR040"),
+                                      cms.InputTag("leptonIsolation","electrons-h0-DR040"),
+                                      cms.InputTag("leptonIsolation","electrons-gamma-DR040")),
         jets         = cms.InputTag("ak4PFJetsCHS"),
+        jetKeepMask  = cms.InputTag("jetLeptonOverlaps"),
         met          = cms.InputTag("pfMet"),
         genParts     = cms.InputTag("genParticles"),
         genJets      = cms.InputTag("ak4GenJets"),
+        genJetKeepMask = cms.InputTag("genJetLeptonOverlaps"),
         vertices     = cms.InputTag("offlinePrimaryVertices"),
-        HGCalIDToolConfig = cms.PSet(
-            HGCBHInput = cms.InputTag("HGCalRecHit","HGCHEBRecHits"),
-            HGCEEInput = cms.InputTag("HGCalRecHit","HGCEERecHits"),
-            HGCFHInput = cms.InputTag("HGCalRecHit","HGCHEFRecHits"),
-            HGCPFRecHits = cms.InputTag("particleFlowRecHitHGC::MiniAnalysis"),
-            withPileup = cms.bool(True),
-            debug = cms.bool(False),
-        ),
+        vertexContext = cms.InputTag("vertexContext"),
         
 
 )
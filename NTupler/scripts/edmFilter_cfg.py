@@ -93,7 +93,11 @@ process.load('RecoMET.METProducers.PFMET_cfi')
 process.puppiMet = process.pfMet.clone()
 process.puppiMet.src = cms.InputTag('puppi')
 
-process.puSequence = cms.Sequence(process.pfNoLepPUPPI * process.puppi * process.puppiNoLep * process.ak4PUPPIJets * process.puppiMet)
+# lepton isolation sums, computed in a single pass over the no-lepton PUPPI candidates
+process.load("PhaseTwoAnalysis.Common.MultiConeIsolationProducer_cfi")
+process.leptonIsolation.pfCands = cms.InputTag("puppiNoLep")
+
+process.puSequence = cms.Sequence(process.pfNoLepPUPPI * process.puppi * process.puppiNoLep * process.leptonIsolation * process.ak4PUPPIJets * process.puppiMet)
 
 # PF cluster producer for HFCal ID
 process.load("RecoParticleFlow.PFClusterProducer.particleFlowRecHitHGC_cff")
@@ -111,8 +115,8 @@ if (options.inputFormat.lower() == "reco"):
     moduleElecName = "RecoElectronFilter"
 process.electronfilter = cms.EDProducer(moduleElecName)
 process.load("PhaseTwoAnalysis.Electrons."+moduleElecName+"_cfi")
-if (options.inputFormat.lower() == "reco"):
-    process.electronfilter.pfCandsNoLep = "puppiNoLep"
+# conversion veto of the electrons, computed once per event
+process.load("PhaseTwoAnalysis.Electrons.ConversionVetoProducer_cfi")
 
 # muon producer
 moduleMuonName = "PatMuonFilter"    
@@ -148,6 +152,25 @@ else:
                             jetCorrections = ('AK4PFPuppi', ['L1FastJet','L2Relative','L3Absolute'], 'None')
                             )
         process.jetfilter.jets = "updatedPatJetsUpdatedJECAK4PFPuppi"
+
+# jets overlapping with a lepton, computed once per event on the jet collection of the filter
+process.load("PhaseTwoAnalysis.Common.OverlapRemovalProducer_cfi")
+overlapName = "patJetLeptonOverlaps"
+if (options.inputFormat.lower() == "reco"):
+    overlapName = "jetLeptonOverlaps"
+jetOverlaps = getattr(process, overlapName)
+jetOverlaps.jets = process.jetfilter.jets
+
+# primary vertex and object IDs, computed once per event and read by the filters as packed working point bits
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Muons.MuonIDProducer_cfi")
+process.load("PhaseTwoAnalysis.Electrons.ElectronIDProducer_cfi")
+process.load("PhaseTwoAnalysis.Jets.PatJetIDProducer_cfi")
+if (options.inputFormat.lower() == "reco"):
+    process.idSequence = cms.Sequence(process.vertexContext * process.muonIDStoredBend * process.electronID)
+else:
+    process.patJetID.jets = process.jetfilter.jets
+    process.idSequence = cms.Sequence(process.patVertexContext * process.patMuonID * process.patElectronID)
         
 # output
 process.out = cms.OutputModule("PoolOutputModule",
@@ -166,14 +189,14 @@ process.out = cms.OutputModule("PoolOutputModule",
 # run
 if (options.inputFormat.lower() == "reco"):
     if options.updateJEC:
-        process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.electronfilter * process.muonfilter * process.jetfilter)
+        process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.conversionVeto * process.idSequence * process.electronfilter * process.muonfilter * jetOverlaps * process.jetfilter)
     else:
-        process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.electronfilter * process.muonfilter * process.jetfilter)
+        process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.conversionVeto * process.idSequence * process.electronfilter * process.muonfilter * jetOverlaps * process.jetfilter)
 else:
     if options.updateJEC:
-        process.p = cms.Path(process.electronfilter * process.muonfilter * process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.jetfilter)
+        process.p = cms.Path(process.patConversionVeto * process.idSequence * process.electronfilter * process.muonfilter * process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * jetOverlaps * process.patJetID * process.jetfilter)
     else:
-        process.p = cms.Path(process.electronfilter * process.muonfilter * process.jetfilter)
+        process.p = cms.Path(process.patConversionVeto * process.idSequence * process.electronfilter * process.muonfilter * jetOverlaps * process.patJetID * process.jetfilter)
 
 process.e = cms.EndPath(process.out)
     
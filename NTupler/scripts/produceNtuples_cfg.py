@@ -22,10 +22,51 @@ options.register('updateJEC', '',
                  VarParsing.varType.string,
                  "Name of the SQLite file (with path and extension) used to update the jet collection to the latest JEC and the era of the new JEC"
                 )
+options.register('nThreads', 1,
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.int,
+                 "Number of threads (and streams) used by cmsRun"
+                 )
+options.register('layout', 'delphes',
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string,
+                 "layout of the output: delphes (ten trees, for DAnalysis) or wide (one tree with prefixed branches)"
+                 )
+options.register('asyncWrite', False,
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.bool,
+                 "fill and compress the output trees in a dedicated thread"
+                 )
+options.register('perStreamOutput', False,
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.bool,
+                 "write one file per stream and merge them into the output file at the end of the job"
+                 )
+options.register('compact', False,
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.bool,
+                 "compact output: UChar_t flags, reduced-precision eta/phi/mass and no redundant gen columns"
+                 )
+options.register('ioProfile', 'default',
+                 VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string,
+                 "compression and clustering of the output trees: default, fast-write, archival or custom (customIO of ntupleWriter)"
+                 )
+options.register('collections', '',
+                 VarParsing.multiplicity.list,
+                 VarParsing.varType.string,
+                 "collections (e.g. JetPUPPI) or branches (e.g. Particle.PT) to produce and write, all of them by default"
+                 )
 options.parseArguments()
 
 process = cms.Process("MiniAnalysis")
 
+# Multithreading
+process.options = cms.untracked.PSet(
+        numberOfThreads = cms.untracked.uint32(options.nThreads),
+        numberOfStreams = cms.untracked.uint32(0)
+)
+
 # Geometry, GT, and other standard sequences
 process.load('Configuration.Geometry.GeometryExtended2023D17Reco_cff')
 process.load("Configuration.StandardSequences.MagneticField_cff")
@@ -93,33 +134,16 @@ if (options.inputFormat.lower() == "reco"):
         jetLabel = "ak4PUPPIJetsL1FastL2L3"
     else:    
         jetLabel = "ak4PUPPIJets"
-process.selectedMuons = cms.EDFilter("CandPtrSelector",
-                                     src = cms.InputTag(muonLabel),
-                                     cut = cms.string("pt>10 && abs(eta)<3")
+# cheap prefilter on the raw RECO leptons (recoPrefilter), run before the PUPPI, jet and HGCal sequences,
+# and the skim itself: leptons and jets are counted in a single module, stopping as soon as the counts are decided
+process.load("PhaseTwoAnalysis.Common.LeptonJetCountFilter_cfi")
+process.preYieldFilter = process.recoPrefilter.clone(
+                                     leptons      = cms.VInputTag(muonLabel, elecLabel),
+                                     jets         = cms.InputTag(jetLabel),
+                                     minJets      = cms.uint32(2),
+                                     jetPtMin     = cms.double(20.),
+                                     jetEtaMax    = cms.double(5.),
                                      )
-process.selectedElectrons = cms.EDFilter("CandPtrSelector",
-                                         src = cms.InputTag(elecLabel),
-                                         cut = cms.string("pt>10 && abs(eta)<3")
-                                         )
-process.selectedJets = cms.EDFilter("CandPtrSelector",
-                                    src = cms.InputTag(jetLabel),
-                                    cut = cms.string("pt>20 && abs(eta)<5")
-                                    )
-process.allLeps = cms.EDProducer("CandViewMerger",
-                                 src = cms.VInputTag(
-                                                     cms.InputTag("selectedElectrons"),
-                                                     cms.InputTag("selectedMuons")
-                                                     )
-                                 )
-process.countLeps = cms.EDFilter("CandViewCountFilter",
-                                 src = cms.InputTag("allLeps"),
-                                 minNumber = cms.uint32(1)
-                                 )
-process.countJets = cms.EDFilter("CandViewCountFilter",
-                                 src = cms.InputTag("selectedJets"),
-                                 minNumber = cms.uint32(2)
-                                 )
-process.preYieldFilter = cms.Sequence(process.selectedMuons+process.selectedElectrons+process.allLeps+process.countLeps+process.selectedJets+process.countJets)
 
 
 # run Puppi 
@@ -134,6 +158,10 @@ process.particleFlowNoLep = cms.EDFilter("PdgIdCandViewSelector",
                                     pdgId = cms.vint32( 1,2,22,111,130,310,2112,211,-211,321,-321,999211,2212,-2212 )
                                     )
 process.puppiNoLep = process.puppi.clone(candName = cms.InputTag('particleFlowNoLep'))
+
+# lepton isolation sums, computed in a single pass over the no-lepton PUPPI candidates
+process.load("PhaseTwoAnalysis.Common.MultiConeIsolationProducer_cfi")
+process.leptonIsolation.pfCands = cms.InputTag("puppiNoLep")
 process.load("PhysicsTools.PatAlgos.slimming.primaryVertexAssociation_cfi")
 process.load("PhysicsTools.PatAlgos.slimming.offlineSlimmedPrimaryVertices_cfi")
 process.load("PhysicsTools.PatAlgos.slimming.packedPFCandidates_cfi")
@@ -161,10 +189,22 @@ process.electronTrackIsolationLcone.intRadiusEndcap = 0.04
 moduleName = "MiniFromPat"    
 if (options.inputFormat.lower() == "reco"):
     moduleName = "MiniFromReco"
-process.ntuple = cms.EDAnalyzer(moduleName)
+process.ntuple = cms.EDProducer(moduleName)
 process.load("PhaseTwoAnalysis.NTupler."+moduleName+"_cfi")
+# conversion veto of the electrons, computed once per event
+process.load("PhaseTwoAnalysis.Electrons.ConversionVetoProducer_cfi")
+if options.perStreamOutput:
+    process.load("PhaseTwoAnalysis.NTupler.MiniEventStreamWriter_cfi")
+else:
+    process.load("PhaseTwoAnalysis.NTupler.MiniEventWriter_cfi")
+    process.ntupleWriter.asyncWrite = options.asyncWrite
+process.ntupleWriter.layout = options.layout
+process.ntupleWriter.ioProfile = options.ioProfile
+process.ntupleWriter.compact = options.compact
+if options.collections:
+    process.ntuple.collections = cms.vstring(options.collections)
+    process.ntupleWriter.collections = cms.vstring(options.collections)
 if (options.inputFormat.lower() == "reco"):
-    process.ntuple.pfCandsNoLep = "puppiNoLep"
     process.ntuple.met = "puppiMet"
     if options.updateJEC:
         # This will load several ESProducers and EDProducers which make the corrected jet collections
@@ -187,6 +227,49 @@ else:
                             )
         process.ntuple.jets = "updatedPatJetsUpdatedJECAK4PFPuppi"
 
+# jets and gen jets overlapping with a lepton, computed once per event on the jet collections of the ntupler
+process.load("PhaseTwoAnalysis.Common.OverlapRemovalProducer_cfi")
+if (options.inputFormat.lower() == "reco"):
+    process.jetLeptonOverlaps.jets = process.ntuple.jets
+    process.overlapSequence = cms.Sequence(process.jetLeptonOverlaps * process.genJetLeptonOverlaps)
+else:
+    process.patJetLeptonOverlaps.jets = process.ntuple.jets
+    process.overlapSequence = cms.Sequence(process.patJetLeptonOverlaps * process.patGenJetLeptonOverlaps)
+
+# primary vertex and object IDs, computed once per event and read by the ntupler as packed working point bits;
+# the IDs (and their inputs: conversion veto, HGCal rechits, track isolation) of the objects whose collections
+# are not kept are not run
+def keeps(*names):
+    return not options.collections or any(c.split(".")[0] in names for c in options.collections)
+keepElecs = keeps("ElectronLoose", "ElectronTight")
+keepMuons = keeps("MuonLoose", "MuonTight")
+keepJets = keeps("JetPUPPI")
+process.load("PhaseTwoAnalysis.Common.VertexContextProducer_cfi")
+process.load("PhaseTwoAnalysis.Muons.MuonIDProducer_cfi")
+process.load("PhaseTwoAnalysis.Electrons.ElectronIDProducer_cfi")
+process.load("PhaseTwoAnalysis.Jets.PatJetIDProducer_cfi")
+if (options.inputFormat.lower() == "reco"):
+    process.electronID.mvaWeights = "TMVAClassification_BDT.forest"
+    process.electronID.HGCalIDToolConfig.HGCPFRecHits = "particleFlowRecHitHGC::MiniAnalysis"
+    process.idSequence = cms.Sequence(process.vertexContext)
+    if keepMuons:
+        process.idSequence += process.muonID
+    if keepElecs:
+        process.idSequence += process.electronTrackIsolationLcone
+        process.idSequence += process.particleFlowRecHitHGCSeq
+        process.idSequence += process.conversionVeto
+        process.idSequence += process.electronID
+else:
+    process.patJetID.jets = process.ntuple.jets
+    process.idSequence = cms.Sequence(process.patVertexContext)
+    if keepMuons:
+        process.idSequence += process.patMuonID
+    if keepElecs:
+        process.idSequence += process.patConversionVeto
+        process.idSequence += process.patElectronID
+    if keepJets:
+        process.idSequence += process.patJetID
+
 # output
 process.TFileService = cms.Service("TFileService",
                                    fileName = cms.string(options.outFilename)
@@ -194,27 +277,27 @@ process.TFileService = cms.Service("TFileService",
 
 # run
 if (options.inputFormat.lower() == "reco"):
-    process.puSequence = cms.Sequence(process.primaryVertexAssociation * process.pfNoLepPUPPI * process.puppi * process.particleFlowNoLep * process.puppiNoLep * process.offlineSlimmedPrimaryVertices * process.packedPFCandidates * process.muonIsolationPUPPI * process.muonIsolationPUPPINoLep * process.ak4PUPPIJets * process.puppiMet)
+    process.puSequence = cms.Sequence(process.primaryVertexAssociation * process.pfNoLepPUPPI * process.puppi * process.particleFlowNoLep * process.puppiNoLep * process.leptonIsolation * process.offlineSlimmedPrimaryVertices * process.packedPFCandidates * process.muonIsolationPUPPI * process.muonIsolationPUPPINoLep * process.ak4PUPPIJets * process.puppiMet)
 
 if options.skim:
     if (options.inputFormat.lower() == "reco"):
         if options.updateJEC:
-            process.p = cms.Path(process.weightCounter * process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.preYieldFilter * process.ntuple)
+            process.p = cms.Path(process.weightCounter * process.recoPrefilter * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.preYieldFilter * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
         else:
-            process.p = cms.Path(process.weightCounter * process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.preYieldFilter * process.ntuple)
+            process.p = cms.Path(process.weightCounter * process.recoPrefilter * process.puSequence * process.preYieldFilter * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
     else:
         if options.updateJEC:
-            process.p = cms.Path(process.weightCounter*process.preYieldFilter*process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.ntuple)
+            process.p = cms.Path(process.weightCounter*process.preYieldFilter*process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
         else:
-            process.p = cms.Path(process.weightCounter*process.preYieldFilter*process.ntuple)
+            process.p = cms.Path(process.weightCounter*process.preYieldFilter*process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
 else:
     if (options.inputFormat.lower() == "reco"):
         if options.updateJEC:
-            process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.ntuple)
+            process.p = cms.Path(process.puSequence * process.ak4PFPuppiL1FastL2L3CorrectorChain * process.ak4PUPPIJetsL1FastL2L3 * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
         else:
-            process.p = cms.Path(process.electronTrackIsolationLcone * process.particleFlowRecHitHGCSeq * process.puSequence * process.ntuple)
+            process.p = cms.Path(process.puSequence * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
     else:
         if options.updateJEC:
-            process.p = cms.Path(process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.ntuple)
+            process.p = cms.Path(process.patJetCorrFactorsUpdatedJECAK4PFPuppi * process.updatedPatJetsUpdatedJECAK4PFPuppi * process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
 	else:    
-            process.p = cms.Path(process.ntuple)
+            process.p = cms.Path(process.idSequence * process.overlapSequence * process.ntuple * process.ntupleWriter)
@@ -1,90 +1,416 @@
 #include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventCompact.h"
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventSelector.h"
 
-void createMiniEventTree(TTree *t_event_, TTree *t_genParts_, TTree *t_vertices_, TTree *t_genJets_, TTree *t_looseElecs_, TTree *t_tightElecs_, TTree *t_looseMuons_, TTree *t_tightMuons_, TTree *t_puppiJets_, TTree *t_puppiMET_,MiniEvent_t &ev)
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "RVersion.h"
+#include "Compression.h"
+#include "TFile.h"
+#include "TObjArray.h"
+
+namespace {
+  template<typename T>
+    void *bufferData(void *buffer)
+    {
+      return static_cast<MiniEventBuffer<T>*>(buffer)->data();
+    }
+}
+
+bool parseMiniEventLayout(const std::string &name, MiniEventLayout &layout)
+{
+  if (name == "delphes") layout = DELPHES_LAYOUT;
+  else if (name == "wide") layout = WIDE_LAYOUT;
+  else return false;
+  return true;
+}
+
+std::vector<std::string> miniEventTreeNames(MiniEventLayout layout, const MiniEventContent &content)
+{
+  if (layout == WIDE_LAYOUT) return std::vector<std::string>(1, "MiniEvent");
+  const char* names[10] = {"Event", "Particle", "Vertex", "GenJet", "ElectronLoose", "ElectronTight", "MuonLoose", "MuonTight", "JetPUPPI", "PuppiMissingET"};
+  std::vector<std::string> kept;
+  for (size_t i = 0; i < 10; i++)
+    if (content.has(names[i])) kept.push_back(names[i]);
+  return kept;
+}
+
+MiniEventIOProfile::MiniEventIOProfile():
+  compression(-1), basketSize(0), optimizeAfter(0), autoFlush(0)
+{
+}
+
+MiniEventIOProfile::MiniEventIOProfile(const edm::ParameterSet &iConfig):
+  MiniEventIOProfile()
+{
+  const std::string ioProfile = iConfig.getParameter<std::string>("ioProfile");
+  if (ioProfile == "custom") {
+    const edm::ParameterSet& custom = iConfig.getParameterSet("customIO");
+    const std::string algorithm = custom.getParameter<std::string>("compressionAlgorithm");
+    if (!miniEventCompression(algorithm, custom.getParameter<int>("compressionLevel"), compression))
+      throw cms::Exception("Configuration") << "MiniEventIOProfile: unknown compression algorithm " << algorithm;
+    basketSize = custom.getParameter<int>("basketSize");
+    optimizeAfter = custom.getParameter<unsigned int>("optimizeAfter");
+    autoFlush = custom.getParameter<unsigned int>("autoFlush");
+  }
+  else if (!parseMiniEventIOProfile(ioProfile, *this))
+    throw cms::Exception("Configuration") << "MiniEventIOProfile: unknown ioProfile " << ioProfile;
+}
+
+void fillMiniEventWriterDescription(edm::ParameterSetDescription &desc)
+{
+  desc.add<edm::InputTag>("src", edm::InputTag("ntuple"));
+  desc.add<std::string>("layout", "delphes");
+  desc.add<std::vector<std::string>>("collections", miniEventTreeNames());
+  desc.add<bool>("compact", false);
+  desc.add<bool>("writeIndex", true);
+  desc.add<std::string>("ioProfile", "default");
+  edm::ParameterSetDescription customIO;
+  customIO.add<std::string>("compressionAlgorithm", "zlib");
+  customIO.add<int>("compressionLevel", 4);
+  customIO.add<int>("basketSize", 32000);
+  customIO.add<unsigned int>("optimizeAfter", 1000);
+  customIO.add<unsigned int>("autoFlush", 10000);
+  desc.add<edm::ParameterSetDescription>("customIO", customIO);
+  edm::ParameterSetDescription selection;
+  MiniEventSelector::fillDescription(selection);
+  desc.add<edm::ParameterSetDescription>("selection", selection);
+}
+
+std::string miniEventTemporaryFileName(const std::string &outputName, const std::string &suffix)
+{
+  std::string base = outputName;
+  if (base.size() > 5 && base.compare(base.size() - 5, 5, ".root") == 0) base.resize(base.size() - 5);
+  return base + "_" + suffix + ".root";
+}
+
+void mergeMiniEventTrees(const std::string &fileName, const std::vector<std::string> &names, TDirectory *dir, std::vector<TTree*> &merged)
 {
+  TFile* in = TFile::Open(fileName.c_str(), "READ");
+  if (!in || in->IsZombie())
+    throw cms::Exception("FileOpenError") << "mergeMiniEventTrees: cannot reopen " << fileName;
+  for (size_t i = 0; i < names.size(); i++) {
+    TTree* t = (TTree*)in->Get(names[i].c_str());
+    if (!t)
+      throw cms::Exception("MissingTree") << "mergeMiniEventTrees: no " << names[i] << " tree in " << fileName;
+    if (!merged[i]) {
+      merged[i] = t->CloneTree(0);
+      merged[i]->SetDirectory(dir);
+    }
+    merged[i]->CopyEntries(t, -1, "fast");
+  }
+  in->Close();
+  delete in;
+}
+
+bool parseMiniEventIOProfile(const std::string &name, MiniEventIOProfile &profile)
+{
+  profile = MiniEventIOProfile();
+  if (name == "default") return true;
+  if (name == "fast-write") {
+    miniEventCompression("lz4", 4, profile.compression);
+    profile.basketSize = 16000;
+    profile.optimizeAfter = 200;
+    profile.autoFlush = 2000;
+  }
+  else if (name == "archival") {
+    miniEventCompression("lzma", 9, profile.compression);
+    profile.basketSize = 64000;
+    profile.optimizeAfter = 1000;
+    profile.autoFlush = 20000;
+  }
+  else return false;
+  return true;
+}
+
+bool miniEventCompression(const std::string &algorithm, int level, int &settings)
+{
+  if (algorithm == "zlib") settings = ROOT::CompressionSettings(ROOT::kZLIB, level);
+  else if (algorithm == "lzma") settings = ROOT::CompressionSettings(ROOT::kLZMA, level);
+  else if (algorithm == "lz4") {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,12,0)
+    settings = ROOT::CompressionSettings(ROOT::kLZ4, level);
+#else
+    settings = ROOT::CompressionSettings(ROOT::kZLIB, 1);
+#endif
+  }
+  else if (algorithm == "zstd") {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+    settings = ROOT::CompressionSettings(ROOT::kZSTD, level);
+#else
+    settings = ROOT::CompressionSettings(ROOT::kLZMA, level);
+#endif
+  }
+  else return false;
+  return true;
+}
+
+MiniEventContent::MiniEventContent():
+  all_(true)
+{
+}
+
+MiniEventContent::MiniEventContent(const std::vector<std::string> &keep):
+  all_(false)
+{
+  for (size_t i = 0; i < keep.size(); i++) {
+    const size_t dot = keep[i].find('.');
+    if (dot == std::string::npos) collections_.insert(keep[i]);
+    else {
+      partial_.insert(keep[i].substr(0, dot));
+      branches_.insert(keep[i]);
+    }
+  }
+}
+
+bool MiniEventContent::has(const std::string &collection) const
+{
+  return all_ || collection == "Event" || collections_.count(collection) || partial_.count(collection);
+}
+
+bool MiniEventContent::has(const std::string &collection, const std::string &branch) const
+{
+  return all_ || collection == "Event" || collections_.count(collection) || branches_.count(collection + "." + branch);
+}
+
+bool MiniEventContent::checkNames(std::string &name) const
+{
+  const std::vector<std::string> known = miniEventTreeNames(DELPHES_LAYOUT);
+  std::set<std::string> all(collections_);
+  all.insert(partial_.begin(), partial_.end());
+  for (const std::string &collection : all) {
+    if (std::find(known.begin(), known.end(), collection) != known.end()) continue;
+    name = collection;
+    return false;
+  }
+  return true;
+}
+
+MiniEventTrees::MiniEventTrees(TDirectory *dir, MiniEvent_t &ev, MiniEventLayout layout, const MiniEventContent &content, bool compact):
+  ev_(ev),
+  content_(content),
+  compact_(compact),
+  collections_(miniEventTreeNames(DELPHES_LAYOUT)),
+  collectionSize_(collections_.size(), 0),
+  entries_(0)
+{
+  const std::vector<std::string> names = miniEventTreeNames(layout, content_);
+  for (size_t i = 0; i < names.size(); i++) {
+    trees_.push_back(new TTree(names[i].c_str(), names[i].c_str()));
+    trees_.back()->SetDirectory(dir);
+  }
+
+  size_t itree = 0;
+  for (size_t i = 0; i < collections_.size(); i++) {
+    if (layout == WIDE_LAYOUT) {
+      // one tree, the branches are prefixed with the name of the Delphes-like tree, except the event header
+      collectionTree_.push_back(content_.has(collections_[i]) ? trees_[0] : 0);
+      collectionPrefix_.push_back(i > 0 ? collections_[i] + "_" : "");
+    }
+    else {
+      collectionTree_.push_back(content_.has(collections_[i]) ? trees_[itree++] : 0);
+      collectionPrefix_.push_back("");
+    }
+  }
+  bookBranches();
+}
+
+void MiniEventTrees::setIOProfile(const MiniEventIOProfile &profile)
+{
+  for (size_t i = 0; i < trees_.size(); i++) {
+    TTree *t = trees_[i];
+    if (profile.compression >= 0) {
+      TObjArray *branches = t->GetListOfBranches();
+      for (int b = 0; b < branches->GetEntriesFast(); b++) static_cast<TBranch*>(branches->At(b))->SetCompressionSettings(profile.compression);
+    }
+    if (profile.basketSize > 0) t->SetBasketSize("*", profile.basketSize);
+    // same cluster boundaries in all the trees, so that they can be read in parallel cluster by cluster
+    if (profile.autoFlush > 0) t->SetAutoFlush(profile.autoFlush);
+  }
+  profile_ = profile;
+}
+
+void MiniEventTrees::fill()
+{
+  for (size_t i = 0; i < roundedColumns_.size(); i++) {
+    MiniEventBuffer<Float_t> &buffer = *roundedColumns_[i].buffer;
+    for (Int_t j = 0; j < *roundedColumns_[i].size; j++) buffer[j] = miniEventCompact::reduceMantissa(buffer[j], roundedColumns_[i].nbits);
+  }
+  for (size_t i = 0; i < flagColumns_.size(); i++) {
+    FlagColumn &column = flagColumns_[i];
+    column.packed.resize(std::max(*column.size, 1));
+    for (Int_t j = 0; j < *column.size; j++) column.packed[j] = miniEventCompact::packFlags((*column.buffer)[j]);
+    column.branch->SetAddress(column.packed.data());
+  }
+  for (size_t i = 0; i < columns_.size(); i++) columns_[i].branch->SetAddress(columns_[i].data(columns_[i].buffer));
+  for (size_t i = 0; i < counters_.size(); i++) counters_[i].highWaterMark = std::max(counters_[i].highWaterMark, *counters_[i].size);
+  for (size_t i = 0; i < trees_.size(); i++) trees_[i]->Fill();
+  MiniEventIndex::Entry key = {(uint32_t)ev_.run, (uint32_t)ev_.lumi, (uint64_t)ev_.event, (uint64_t)entries_};
+  index_.push_back(key);
+
+  // the baskets of each tree are sized from the bytes per entry of its branches so far,
+  // for a cluster of autoFlush entries to fit in about one basket per branch
+  if (++entries_ != profile_.optimizeAfter) return;
+  const Long64_t clusterEntries = std::max(profile_.autoFlush, entries_);
+  for (size_t i = 0; i < trees_.size(); i++)
+    trees_[i]->OptimizeBaskets(trees_[i]->GetTotBytes() / entries_ * clusterEntries, 1.1, "");
+}
+
+std::vector<std::pair<std::string, Int_t> > MiniEventTrees::highWaterMarks() const
+{
+  std::vector<std::pair<std::string, Int_t> > marks;
+  for (size_t i = 0; i < counters_.size(); i++) marks.push_back(std::make_pair(counters_[i].name, counters_[i].highWaterMark));
+  return marks;
+}
+
+void MiniEventTrees::bookScalar(size_t collection, const char *name, Int_t *address)
+{
+  if (!content_.has(collections_[collection], name)) return;
+  const std::string branch = collectionPrefix_[collection] + name;
+  collectionTree_[collection]->Branch(branch.c_str(), address, (branch + "/I").c_str());
+}
+
+void MiniEventTrees::bookScalar(size_t collection, const char *name, Long64_t *address)
+{
+  if (!content_.has(collections_[collection], name)) return;
+  const std::string branch = collectionPrefix_[collection] + name;
+  collectionTree_[collection]->Branch(branch.c_str(), address, (branch + "/L").c_str());
+}
+
+void MiniEventTrees::bookCounter(size_t collection, const char *name, Int_t *size)
+{
+  // the _size counters are never prefixed
+  if (!content_.has(collections_[collection])) return;
+  collectionTree_[collection]->Branch(name, size, (std::string(name) + "/I").c_str());
+  Counter counter = {name, size, 0};
+  counters_.push_back(counter);
+  collectionSize_[collection] = size;
+}
+
+template<typename T>
+  void MiniEventTrees::bookColumn(size_t collection, const char *name, MiniEventBuffer<T> &buffer, const char *leaf)
+{
+  // leaf is e.g. "[JetPUPPI_size]/F"
+  if (!content_.has(collections_[collection], name)) return;
+  const std::string branch = collectionPrefix_[collection] + name;
+  Column column = {collectionTree_[collection]->Branch(branch.c_str(), buffer.data(), (branch + leaf).c_str()), &buffer, &bufferData<T>};
+  columns_.push_back(column);
+}
+
+void MiniEventTrees::bookRoundedColumn(size_t collection, const char *name, MiniEventBuffer<Float_t> &buffer, const char *leaf, int nbits)
+{
+  if (!content_.has(collections_[collection], name)) return;
+  bookColumn(collection, name, buffer, leaf);
+  if (!compact_) return;
+  RoundedColumn column = {&buffer, collectionSize_[collection], nbits};
+  roundedColumns_.push_back(column);
+}
+
+void MiniEventTrees::bookFlagColumn(size_t collection, const char *name, MiniEventBuffer<Int_t> &buffer, const char *leaf)
+{
+  if (!content_.has(collections_[collection], name)) return;
+  if (!compact_) {
+    bookColumn(collection, name, buffer, (std::string(leaf) + "/I").c_str());
+    return;
+  }
+  FlagColumn column = {0, &buffer, collectionSize_[collection], std::vector<UChar_t>(1, 0)};
+  flagColumns_.push_back(column);
+  const std::string branch = collectionPrefix_[collection] + name;
+  flagColumns_.back().branch = collectionTree_[collection]->Branch(branch.c_str(), flagColumns_.back().packed.data(), (branch + leaf + "/b").c_str());
+}
+
+void MiniEventTrees::bookBranches()
+{
+  MiniEvent_t &ev = ev_;
+
   //event header
-  t_event_->Branch("Run",               &ev.run,        "Run/I");
-  t_event_->Branch("Event",             &ev.event,      "Event/I");
-  t_event_->Branch("Lumi",              &ev.lumi,       "Lumi/I");
+  bookScalar(0, "Run",               &ev.run);
+  bookScalar(0, "Event",             &ev.event);
+  bookScalar(0, "Lumi",              &ev.lumi);
 
   //gen level event
-  t_genParts_->Branch("Particle_size",  &ev.ngl,        "Particle_size/I");
-  t_genParts_->Branch("PID",            ev.gl_pid,      "PID[Particle_size]/I");
-  t_genParts_->Branch("Charge",         ev.gl_ch,       "Charge[Particle_size]/I");
-  t_genParts_->Branch("Status",         ev.gl_st,       "Status[Particle_size]/I");
-  t_genParts_->Branch("P",              ev.gl_p,        "P[Particle_size]/F");
-  t_genParts_->Branch("Px",             ev.gl_px,       "Px[Particle_size]/F");
-  t_genParts_->Branch("Py",             ev.gl_py,       "Py[Particle_size]/F");
-  t_genParts_->Branch("Pz",             ev.gl_pz,       "Pz[Particle_size]/F");
-  t_genParts_->Branch("E",              ev.gl_nrj,      "E[Particle_size]/F");
-  t_genParts_->Branch("PT",             ev.gl_pt,       "PT[Particle_size]/F");
-  t_genParts_->Branch("Eta",            ev.gl_eta,      "Eta[Particle_size]/F");
-  t_genParts_->Branch("Phi",            ev.gl_phi,      "Phi[Particle_size]/F");
-  t_genParts_->Branch("Mass",           ev.gl_mass,     "Mass[Particle_size]/F");
-  t_genParts_->Branch("IsolationVar",   ev.gl_relIso,   "IsolationVar/F");
-
-  t_genJets_->Branch("GenJet_size",     &ev.ngj,        "GenJet_size/I");
-  t_genJets_->Branch("PT",              ev.gj_pt,       "PT[GenJet_size]/F");
-  t_genJets_->Branch("Eta",             ev.gj_eta,      "Eta[GenJet_size]/F");
-  t_genJets_->Branch("Phi",             ev.gj_phi,      "Phi[GenJet_size]/F");
-  t_genJets_->Branch("Mass",            ev.gj_mass,     "Mass[GenJet_size]/F");
+  bookCounter(1, "Particle_size",  &ev.ngl);
+  bookColumn(1, "PID",            ev.gl_pid,      "[Particle_size]/I");
+  bookColumn(1, "Charge",         ev.gl_ch,       "[Particle_size]/I");
+  bookColumn(1, "Status",         ev.gl_st,       "[Particle_size]/I");
+  if (!compact_) {
+    // redundant with PT, Eta, Phi and Mass, see miniEventCompact::genMomentum
+    bookColumn(1, "P",              ev.gl_p,        "[Particle_size]/F");
+    bookColumn(1, "Px",             ev.gl_px,       "[Particle_size]/F");
+    bookColumn(1, "Py",             ev.gl_py,       "[Particle_size]/F");
+    bookColumn(1, "Pz",             ev.gl_pz,       "[Particle_size]/F");
+    bookColumn(1, "E",              ev.gl_nrj,      "[Particle_size]/F");
+  }
+  bookColumn(1, "PT",             ev.gl_pt,       "[Particle_size]/F");
+  bookRoundedColumn(1, "Eta",     ev.gl_eta,      "[Particle_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(1, "Phi",     ev.gl_phi,      "[Particle_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(1, "Mass",    ev.gl_mass,     "[Particle_size]/F", miniEventCompact::MASS_BITS);
+  bookColumn(1, "IsolationVar",   ev.gl_relIso,   "/F");
+
+  bookCounter(3, "GenJet_size",     &ev.ngj);
+  bookColumn(3, "PT",              ev.gj_pt,       "[GenJet_size]/F");
+  bookRoundedColumn(3, "Eta",      ev.gj_eta,      "[GenJet_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(3, "Phi",      ev.gj_phi,      "[GenJet_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(3, "Mass",     ev.gj_mass,     "[GenJet_size]/F", miniEventCompact::MASS_BITS);
 
   //reco level event
-  t_vertices_->Branch("Vertex_size",    &ev.nvtx,       "Vertex_size/I");
-  t_vertices_->Branch("SumPT2",         &ev.v_pt2,      "SumPT2[Vertex_size]/F");
-
-  t_looseElecs_->Branch("ElectronLoose_size", &ev.nle,  "ElectronLoose_size/I");
-  t_looseElecs_->Branch("Charge",       ev.le_ch,       "Charge[ElectronLoose_size]/I");
-  t_looseElecs_->Branch("Particle",     ev.le_g,        "Particle[ElectronLoose_size]/I");
-  t_looseElecs_->Branch("PT",           ev.le_pt,       "PT[ElectronLoose_size]/F");
-  t_looseElecs_->Branch("Eta",          ev.le_eta,      "Eta[ElectronLoose_size]/F");
-  t_looseElecs_->Branch("Phi",          ev.le_phi,      "Phi[ElectronLoose_size]/F");
-  t_looseElecs_->Branch("Mass",         ev.le_mass,     "Mass[ElectronLoose_size]/F");
-  t_looseElecs_->Branch("IsolationVar", ev.le_relIso,   "IsolationVar[ElectronLoose_size]/F");
-
-  t_tightElecs_->Branch("ElectronTight_size", &ev.nte,  "ElectronTight_size/I");
-  t_tightElecs_->Branch("Charge",       ev.te_ch,       "Charge[ElectronTight_size]/I");
-  t_tightElecs_->Branch("Particle",     ev.te_g,        "Particle[ElectronTight_size]/I");
-  t_tightElecs_->Branch("PT",           ev.te_pt,       "PT[ElectronTight_size]/F");
-  t_tightElecs_->Branch("Eta",          ev.te_eta,      "Eta[ElectronTight_size]/F");
-  t_tightElecs_->Branch("Phi",          ev.te_phi,      "Phi[ElectronTight_size]/F");
-  t_tightElecs_->Branch("Mass",         ev.te_mass,     "Mass[ElectronTight_size]/F");
-  t_tightElecs_->Branch("IsolationVar", ev.te_relIso,   "IsolationVar[ElectronTight_size]/F");
-
-  t_looseMuons_->Branch("MuonLoose_size", &ev.nlm,      "MuonLoose_size/I");
-  t_looseMuons_->Branch("Charge",       ev.lm_ch,       "Charge[MuonLoose_size]/I");
-  t_looseMuons_->Branch("Particle",     ev.lm_g,        "Particle[MuonLoose_size]/I");
-  t_looseMuons_->Branch("PT",           ev.lm_pt,       "PT[MuonLoose_size]/F");
-  t_looseMuons_->Branch("Eta",          ev.lm_eta,      "Eta[MuonLoose_size]/F");
-  t_looseMuons_->Branch("Phi",          ev.lm_phi,      "Phi[MuonLoose_size]/F");
-  t_looseMuons_->Branch("Mass",         ev.lm_mass,     "Mass[MuonLoose_size]/F");
-  t_looseMuons_->Branch("IsolationVar", ev.lm_relIso,   "IsolationVar[MuonLoose_size]/F");
-
-  t_tightMuons_->Branch("MuonTight_size", &ev.ntm,      "MuonTight_size/I");
-  t_tightMuons_->Branch("Charge",       ev.tm_ch,       "Charge[MuonTight_size]/I");
-  t_tightMuons_->Branch("Particle",     ev.tm_g,        "Particle[MuonTight_size]/I");
-  t_tightMuons_->Branch("PT",           ev.tm_pt,       "PT[MuonTight_size]/F");
-  t_tightMuons_->Branch("Eta",          ev.tm_eta,      "Eta[MuonTight_size]/F");
-  t_tightMuons_->Branch("Phi",          ev.tm_phi,      "Phi[MuonTight_size]/F");
-  t_tightMuons_->Branch("Mass",         ev.tm_mass,     "Mass[MuonTight_size]/F");
-  t_tightMuons_->Branch("IsolationVar", ev.tm_relIso,   "IsolationVar[MuonTight_size]/F");
-
-  t_puppiJets_->Branch("JetPUPPI_size", &ev.nj,         "JetPUPPI_size/I");
-  t_puppiJets_->Branch("ID",            ev.j_id,        "ID[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("GenJet",        ev.j_g,         "GenJet[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("PT",            ev.j_pt,        "PT[JetPUPPI_size]/F");
-  t_puppiJets_->Branch("Eta",           ev.j_eta,       "Eta[JetPUPPI_size]/F");
-  t_puppiJets_->Branch("Phi",           ev.j_phi,       "Phi[JetPUPPI_size]/F");
-  t_puppiJets_->Branch("Mass",          ev.j_mass,      "Mass[JetPUPPI_size]/F");
-  t_puppiJets_->Branch("MVAv2",         ev.j_mvav2,     "MVAv2[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("DeepCSV",       ev.j_deepcsv,   "DeepCSV[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("PartonFlavor",  ev.j_flav,      "PartonFlavor[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("HadronFlavor",  ev.j_hadflav,   "HadronFlavor[JetPUPPI_size]/I");
-  t_puppiJets_->Branch("GenPartonPID",  ev.j_pid,       "GenPartonPID[JetPUPPI_size]/I");
-
-  t_puppiMET_->Branch("PuppiMissingET_size", &ev.nmet,  "PuppiMissingET_size/I");
-  t_puppiMET_->Branch("MET",            ev.met_pt,      "MET[PuppiMissingET_size]/F");
-  t_puppiMET_->Branch("Phi",            ev.met_phi,     "Phi[PuppiMissingET_size]/F");
-  t_puppiMET_->Branch("Eta",            ev.met_eta,     "Eta[PuppiMissingET_size]/F");
-}
+  bookCounter(2, "Vertex_size",    &ev.nvtx);
+  bookColumn(2, "SumPT2",         ev.v_pt2,      "[Vertex_size]/F");
+
+  bookCounter(4, "ElectronLoose_size", &ev.nle);
+  bookColumn(4, "Charge",       ev.le_ch,       "[ElectronLoose_size]/I");
+  bookColumn(4, "Particle",     ev.le_g,        "[ElectronLoose_size]/I");
+  bookColumn(4, "PT",           ev.le_pt,       "[ElectronLoose_size]/F");
+  bookRoundedColumn(4, "Eta",   ev.le_eta,      "[ElectronLoose_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(4, "Phi",   ev.le_phi,      "[ElectronLoose_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(4, "Mass",  ev.le_mass,     "[ElectronLoose_size]/F", miniEventCompact::MASS_BITS);
+  bookColumn(4, "IsolationVar", ev.le_relIso,   "[ElectronLoose_size]/F");
 
+  bookCounter(5, "ElectronTight_size", &ev.nte);
+  bookColumn(5, "Charge",       ev.te_ch,       "[ElectronTight_size]/I");
+  bookColumn(5, "Particle",     ev.te_g,        "[ElectronTight_size]/I");
+  bookColumn(5, "PT",           ev.te_pt,       "[ElectronTight_size]/F");
+  bookRoundedColumn(5, "Eta",   ev.te_eta,      "[ElectronTight_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(5, "Phi",   ev.te_phi,      "[ElectronTight_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(5, "Mass",  ev.te_mass,     "[ElectronTight_size]/F", miniEventCompact::MASS_BITS);
+  bookColumn(5, "IsolationVar", ev.te_relIso,   "[ElectronTight_size]/F");
+
+  bookCounter(6, "MuonLoose_size", &ev.nlm);
+  bookColumn(6, "Charge",       ev.lm_ch,       "[MuonLoose_size]/I");
+  bookColumn(6, "Particle",     ev.lm_g,        "[MuonLoose_size]/I");
+  bookColumn(6, "PT",           ev.lm_pt,       "[MuonLoose_size]/F");
+  bookRoundedColumn(6, "Eta",   ev.lm_eta,      "[MuonLoose_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(6, "Phi",   ev.lm_phi,      "[MuonLoose_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(6, "Mass",  ev.lm_mass,     "[MuonLoose_size]/F", miniEventCompact::MASS_BITS);
+  bookColumn(6, "IsolationVar", ev.lm_relIso,   "[MuonLoose_size]/F");
+
+  bookCounter(7, "MuonTight_size", &ev.ntm);
+  bookColumn(7, "Charge",       ev.tm_ch,       "[MuonTight_size]/I");
+  bookColumn(7, "Particle",     ev.tm_g,        "[MuonTight_size]/I");
+  bookColumn(7, "PT",           ev.tm_pt,       "[MuonTight_size]/F");
+  bookRoundedColumn(7, "Eta",   ev.tm_eta,      "[MuonTight_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(7, "Phi",   ev.tm_phi,      "[MuonTight_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(7, "Mass",  ev.tm_mass,     "[MuonTight_size]/F", miniEventCompact::MASS_BITS);
+  bookColumn(7, "IsolationVar", ev.tm_relIso,   "[MuonTight_size]/F");
+
+  bookCounter(8, "JetPUPPI_size", &ev.nj);
+  bookFlagColumn(8, "ID",        ev.j_id,        "[JetPUPPI_size]");
+  bookColumn(8, "GenJet",        ev.j_g,         "[JetPUPPI_size]/I");
+  bookColumn(8, "PT",            ev.j_pt,        "[JetPUPPI_size]/F");
+  bookRoundedColumn(8, "Eta",    ev.j_eta,       "[JetPUPPI_size]/F", miniEventCompact::ETA_BITS);
+  bookRoundedColumn(8, "Phi",    ev.j_phi,       "[JetPUPPI_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(8, "Mass",   ev.j_mass,      "[JetPUPPI_size]/F", miniEventCompact::MASS_BITS);
+  bookFlagColumn(8, "MVAv2",     ev.j_mvav2,     "[JetPUPPI_size]");
+  bookFlagColumn(8, "DeepCSV",   ev.j_deepcsv,   "[JetPUPPI_size]");
+  bookColumn(8, "PartonFlavor",  ev.j_flav,      "[JetPUPPI_size]/I");
+  bookColumn(8, "HadronFlavor",  ev.j_hadflav,   "[JetPUPPI_size]/I");
+  bookColumn(8, "GenPartonPID",  ev.j_pid,       "[JetPUPPI_size]/I");
+
+  bookCounter(9, "PuppiMissingET_size", &ev.nmet);
+  bookColumn(9, "MET",            ev.met_pt,      "[PuppiMissingET_size]/F");
+  bookRoundedColumn(9, "Phi",     ev.met_phi,     "[PuppiMissingET_size]/F", miniEventCompact::PHI_BITS);
+  bookRoundedColumn(9, "Eta",     ev.met_eta,     "[PuppiMissingET_size]/F", miniEventCompact::ETA_BITS);
+}
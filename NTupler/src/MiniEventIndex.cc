@@ -0,0 +1,103 @@
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+  const char MAGIC[8] = {'M', 'E', 'V', 'I', 'D', 'X', '0', '1'};
+  const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint64_t);
+
+  bool lessKey(const MiniEventIndex::Entry &a, const MiniEventIndex::Entry &b)
+  {
+    if (a.run != b.run) return a.run < b.run;
+    if (a.lumi != b.lumi) return a.lumi < b.lumi;
+    return a.event < b.event;
+  }
+
+  bool sameKey(const MiniEventIndex::Entry &a, const MiniEventIndex::Entry &b)
+  {
+    return a.run == b.run && a.lumi == b.lumi && a.event == b.event;
+  }
+}
+
+bool MiniEventIndex::write(const std::string &fileName, std::vector<Entry> entries)
+{
+  // stable, so that the repetitions of an event stay in the entry order
+  std::stable_sort(entries.begin(), entries.end(), lessKey);
+
+  FILE *f = std::fopen(fileName.c_str(), "wb");
+  if (!f) return false;
+  const uint64_t n = entries.size();
+  bool ok = std::fwrite(MAGIC, sizeof(MAGIC), 1, f) == 1 && std::fwrite(&n, sizeof(n), 1, f) == 1;
+  if (ok && n > 0) ok = std::fwrite(entries.data(), sizeof(Entry), n, f) == n;
+  return std::fclose(f) == 0 && ok;
+}
+
+MiniEventIndex::MiniEventIndex(const std::string &fileName):
+  map_(0), mapSize_(0), entries_(0), size_(0)
+{
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= HEADER_SIZE) {
+    void *map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) {
+      map_ = map;
+      mapSize_ = st.st_size;
+    }
+  }
+  close(fd);
+  if (!map_) return;
+
+  const char *bytes = static_cast<const char*>(map_);
+  uint64_t n = 0;
+  std::memcpy(&n, bytes + sizeof(MAGIC), sizeof(n));
+  if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0 || mapSize_ != HEADER_SIZE + n*sizeof(Entry)) return;
+  entries_ = reinterpret_cast<const Entry*>(bytes + HEADER_SIZE);
+  size_ = n;
+}
+
+MiniEventIndex::~MiniEventIndex()
+{
+  if (map_) munmap(map_, mapSize_);
+}
+
+int64_t MiniEventIndex::find(uint32_t run, uint32_t lumi, uint64_t event) const
+{
+  Entry key = {run, lumi, event, 0};
+  const Entry *it = std::lower_bound(begin(), end(), key, lessKey);
+  if (it == end() || !sameKey(*it, key)) return -1;
+  return it->entry;
+}
+
+std::vector<std::pair<uint64_t, uint64_t> > MiniEventIndex::duplicates() const
+{
+  std::vector<std::pair<uint64_t, uint64_t> > pairs;
+  const Entry *first = begin();
+  for (const Entry *it = begin(); it != end(); ++it) {
+    if (!sameKey(*it, *first)) first = it;
+    else if (it != first) pairs.push_back(std::make_pair(first->entry, it->entry));
+  }
+  return pairs;
+}
+
+std::vector<std::pair<uint64_t, uint64_t> > joinMiniEventIndexes(const MiniEventIndex &a, const MiniEventIndex &b)
+{
+  std::vector<std::pair<uint64_t, uint64_t> > pairs;
+  const MiniEventIndex::Entry *ia = a.begin(), *ib = b.begin();
+  while (ia != a.end() && ib != b.end()) {
+    if (lessKey(*ia, *ib)) ++ia;
+    else if (lessKey(*ib, *ia)) ++ib;
+    else {
+      pairs.push_back(std::make_pair(ia->entry, ib->entry));
+      ++ia;
+      ++ib;
+    }
+  }
+  return pairs;
+}
@@ -0,0 +1,70 @@
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEventSelector.h"
+
+#include <cmath>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+MiniEventSelector::MiniEventSelector():
+  minLooseLeptons(0), minTightLeptons(0), minJets(0), minBJets(0),
+  jetPtMin(20.), jetEtaMax(5.), bTagDeepCSV(true), bTagBit(2)
+{
+}
+
+MiniEventSelector::MiniEventSelector(const edm::ParameterSet &selection):
+  minLooseLeptons(selection.getParameter<unsigned int>("minLooseLeptons")),
+  minTightLeptons(selection.getParameter<unsigned int>("minTightLeptons")),
+  minJets(selection.getParameter<unsigned int>("minJets")),
+  minBJets(selection.getParameter<unsigned int>("minBJets")),
+  jetPtMin(selection.getParameter<double>("jetPtMin")),
+  jetEtaMax(selection.getParameter<double>("jetEtaMax")),
+  bTagDeepCSV(true), bTagBit(2)
+{
+  const std::string bTagger = selection.getParameter<std::string>("bTagger");
+  if (bTagger != "DeepCSV" && bTagger != "MVAv2")
+    throw cms::Exception("Configuration") << "MiniEventSelector: unknown b-tagger " << bTagger;
+  bTagDeepCSV = bTagger == "DeepCSV";
+  if (!setBTagWorkingPoint(selection.getParameter<std::string>("bTagWorkingPoint")))
+    throw cms::Exception("Configuration") << "MiniEventSelector: unknown b-tagging working point " << selection.getParameter<std::string>("bTagWorkingPoint");
+}
+
+void MiniEventSelector::fillDescription(edm::ParameterSetDescription &selection)
+{
+  selection.add<unsigned int>("minLooseLeptons", 0);
+  selection.add<unsigned int>("minTightLeptons", 0);
+  selection.add<unsigned int>("minJets", 0);
+  selection.add<unsigned int>("minBJets", 0);
+  selection.add<double>("jetPtMin", 20.);
+  selection.add<double>("jetEtaMax", 5.);
+  selection.add<std::string>("bTagger", "DeepCSV");
+  selection.add<std::string>("bTagWorkingPoint", "medium");
+}
+
+bool MiniEventSelector::setBTagWorkingPoint(const std::string &name)
+{
+  // the flags are (tight | medium<<1 | loose<<2)
+  if (name == "tight") bTagBit = 1;
+  else if (name == "medium") bTagBit = 2;
+  else if (name == "loose") bTagBit = 4;
+  else return false;
+  return true;
+}
+
+bool MiniEventSelector::accept(const MiniEvent_t &ev) const
+{
+  if ((unsigned int)(ev.nle + ev.nlm) < minLooseLeptons) return false;
+  if ((unsigned int)(ev.nte + ev.ntm) < minTightLeptons) return false;
+  if (minJets == 0 && minBJets == 0) return true;
+
+  const MiniEventBuffer<Int_t> &btag = bTagDeepCSV ? ev.j_deepcsv : ev.j_mvav2;
+  unsigned int nj = 0, nb = 0;
+  for (Int_t i = 0; i < ev.nj; i++) {
+    if (ev.j_pt[i] < jetPtMin || std::fabs(ev.j_eta[i]) > jetEtaMax) continue;
+    nj++;
+    // -1: no b-tagging available
+    if (btag[i] > 0 && (btag[i] & bTagBit)) nb++;
+    if (nj >= minJets && nb >= minBJets) return true;
+  }
+  return false;
+}
@@ -0,0 +1,9 @@
+#include "DataFormats/Common/interface/Wrapper.h"
+#include "PhaseTwoAnalysis/NTupler/interface/MiniEvent.h"
+
+namespace PhaseTwoAnalysis_NTupler {
+  struct dictionary {
+    MiniEvent_t ev;
+    edm::Wrapper<MiniEvent_t> wev;
+  };
+}